@@ -0,0 +1,1243 @@
+// Medicion sin ventana: consultas por segundo y percentiles de latencia
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "archivo_mapa.h"
+#include "campo_flujo.h"
+#include "busqueda.h"
+#include "busqueda_asincrona.h"
+#include "busqueda_por_pasos.h"
+#include "cache_rutas.h"
+#include "contraccion.h"
+#include "cuadricula.h"
+#include "delta_stepping.h"
+#include "dstar_lite.h"
+#include "grafo.h"
+#include "grafo_cuadricula.h"
+#include "jps.h"
+#include "lote.h"
+#include "relajacion.h"
+
+using namespace std;
+
+struct Variante {
+    string nombre;
+    OpcionesBusqueda busqueda;
+};
+
+struct Opciones {
+    int columnas = 256;
+    int filas = 256;
+    float espaciado = 20;
+    float densidad = 0.2f;
+    int consultas = 200;
+    unsigned semilla = 1;
+    string mapa;
+    string grafo = "csr";  // csr | implicito
+    string generador = "aleatorio";  // aleatorio | laberinto | habitaciones
+    int habitacion = 8;              // lado de las habitaciones, en celdas
+    string escenarios;               // consultas de un .scen de MovingAI en lugar de al azar
+    bool espacioNuevo = false;       // un EspacioBusqueda por consulta, como antes
+    int escalado = 0;                // > 0: lote paralelo con 1, 2, 4... hasta N hilos
+    int matriz = 0;                  // > 0: matriz de distancias N x N
+    int campo = 0;                   // > 0: campo de distancias con delta-stepping, 1, 2, 4... hasta N hilos
+    float delta = 0;                 // ancho de cubeta de delta-stepping; 0 = por defecto
+    int agentes = 0;                 // > 0: N agentes hacia una misma meta, busquedas frente a campo de flujo
+    bool asincrono = false;          // reemplazo y cancelacion de busquedas en segundo plano
+    int pasos = 0;                   // > 0: busqueda repartida en llamadas de N microsegundos
+    int distanciaMinima = 0;         // en celdas, para forzar consultas largas
+    int tamanoCluster = 32;          // para hpa
+    int replanificacion = 0;         // > 0: pasos de replanificacion con obstaculos nuevos (implicito)
+    int cache = 0;                   // > 0: consultas repetidas con una cache de N rutas y ediciones (implicito)
+    string guardar;                  // archivo binario a escribir con el mapa y lo preprocesado
+    string binario;                  // archivo binario a mapear en lugar de generar el mapa
+    string simd;                     // nivel de la relajacion vectorial, o "comparar" (implicito)
+    string estadisticas;             // archivo .json o .csv con los contadores de cada consulta
+    bool suite = false;              // bateria de escenarios con todas las variantes
+    string tamanos = "128,512";      // lados de los mapas generados de la bateria; 0 = ninguno
+    string densidades = "0.1,0.2,0.3";
+    string salida;                   // .json o .csv con una fila por escenario y variante
+    string base;                     // .csv de una corrida anterior para detectar regresiones
+    float tolerancia = 0.15f;        // aumento de p50 tolerado frente a la base
+    vector<Variante> variantes;
+};
+
+struct Medicion {
+    double consultasPorSegundo = 0;
+    double p50 = 0, p90 = 0, p99 = 0, maximo = 0;
+    double expandidosPromedio = 0;
+    double expansionesPorSegundo = 0;
+    double extraccionesPromedio = 0;
+    double costoTotal = 0;
+    int sinRuta = 0;
+    vector<float> costos;  // por consulta, para comparar con la referencia
+    vector<int> extracciones;
+    vector<EstadisticasBusqueda> estadisticas;
+};
+
+static void mostrarUso() {
+    printf("uso: bench [--columnas N] [--filas N] [--espaciado E] [--densidad P]\n"
+           "             [--mapa archivo.map] [--consultas N] [--semilla S]\n"
+           "             [--grafo csr|implicito] [--generador aleatorio|laberinto|habitaciones]\n"
+           "             [--habitacion LADO] [--escenarios archivo.scen]\n"
+           "             [--espacio reusado|nuevo] [--escalado HILOS] [--matriz N]\n"
+           "             [--campo HILOS] [--delta ANCHO] [--agentes N] [--asincrono]\n"
+           "             [--pasos MICROSEGUNDOS]\n"
+           "             [--distancia-minima CELDAS] [--replanificacion PASOS] [--cache RUTAS] [--cluster K]\n"
+           "             [--guardar archivo.djk | --binario archivo.djk]\n"
+           "             [--simd escalar|sse2|avx2|comparar] [--estadisticas archivo.json|archivo.csv]\n"
+           "             [--algoritmos A[,A...]]   A = dijkstra | aestrella[:heuristica[:peso]] | jps | jps+\n"
+           "                                          | dijkstra-bi | aestrella-bi[:heuristica] | hpa | ch\n"
+           "                                      con sufijo opcional @binaria | @cuaternaria | @radix\n"
+           "                                      heuristica = octil | euclidiana | manhattan\n"
+           "                                      jps, jps+ y hpa solo con --grafo implicito\n"
+           "       bench --suite [--tamanos N[,N...]] [--densidades P[,P...]] [--mapa a.map[,b.map...]]\n"
+           "             [--consultas N] [--algoritmos ...] [--salida resultados.json|resultados.csv]\n"
+           "             [--base anterior.csv] [--tolerancia FRACCION]\n"
+           "       La bateria usa el grafo implicito; cada a.map usa a.map.scen si existe.\n");
+}
+
+// "aestrella:octil:1.5@radix" -> A* ponderado, heuristica octil, monticulo radix
+static bool leerVariante(const string& texto, Variante& variante) {
+    size_t arroba = texto.find('@');
+    if (arroba != string::npos && !leerCola(texto.substr(arroba + 1), variante.busqueda.cola)) return false;
+    vector<string> partes;
+    stringstream flujo(texto.substr(0, arroba));
+    for (string parte; getline(flujo, parte, ':');) partes.push_back(parte);
+    if (partes.empty() || partes.size() > 3) return false;
+    if (!leerAlgoritmo(partes[0], variante.busqueda.algoritmo)) return false;
+    if (partes.size() > 1 && !leerHeuristica(partes[1], variante.busqueda.heuristica)) return false;
+    if (partes.size() > 2) variante.busqueda.peso = (float)atof(partes[2].c_str());
+    variante.nombre = texto;
+    return variante.busqueda.peso >= 1;
+}
+
+static bool leerVariantes(const string& lista, vector<Variante>& variantes) {
+    stringstream flujo(lista);
+    for (string texto; getline(flujo, texto, ',');) {
+        Variante variante;
+        if (!leerVariante(texto, variante)) return false;
+        variantes.push_back(variante);
+    }
+    return !variantes.empty();
+}
+
+static bool leerOpciones(int argc, char** argv, Opciones& opciones) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool tieneValor = i + 1 < argc;
+        if (arg == "--columnas" && tieneValor) opciones.columnas = atoi(argv[++i]);
+        else if (arg == "--filas" && tieneValor) opciones.filas = atoi(argv[++i]);
+        else if (arg == "--espaciado" && tieneValor) opciones.espaciado = (float)atof(argv[++i]);
+        else if (arg == "--densidad" && tieneValor) opciones.densidad = (float)atof(argv[++i]);
+        else if (arg == "--consultas" && tieneValor) opciones.consultas = atoi(argv[++i]);
+        else if (arg == "--semilla" && tieneValor) opciones.semilla = (unsigned)strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--mapa" && tieneValor) opciones.mapa = argv[++i];
+        else if (arg == "--grafo" && tieneValor) opciones.grafo = argv[++i];
+        else if (arg == "--generador" && tieneValor) opciones.generador = argv[++i];
+        else if (arg == "--habitacion" && tieneValor) opciones.habitacion = atoi(argv[++i]);
+        else if (arg == "--escenarios" && tieneValor) opciones.escenarios = argv[++i];
+        else if (arg == "--suite") opciones.suite = true;
+        else if (arg == "--tamanos" && tieneValor) opciones.tamanos = argv[++i];
+        else if (arg == "--densidades" && tieneValor) opciones.densidades = argv[++i];
+        else if (arg == "--salida" && tieneValor) opciones.salida = argv[++i];
+        else if (arg == "--base" && tieneValor) opciones.base = argv[++i];
+        else if (arg == "--tolerancia" && tieneValor) opciones.tolerancia = (float)atof(argv[++i]);
+        else if (arg == "--escalado" && tieneValor) opciones.escalado = atoi(argv[++i]);
+        else if (arg == "--matriz" && tieneValor) opciones.matriz = atoi(argv[++i]);
+        else if (arg == "--campo" && tieneValor) opciones.campo = atoi(argv[++i]);
+        else if (arg == "--delta" && tieneValor) opciones.delta = (float)atof(argv[++i]);
+        else if (arg == "--agentes" && tieneValor) opciones.agentes = atoi(argv[++i]);
+        else if (arg == "--asincrono") opciones.asincrono = true;
+        else if (arg == "--pasos" && tieneValor) opciones.pasos = atoi(argv[++i]);
+        else if (arg == "--distancia-minima" && tieneValor) opciones.distanciaMinima = atoi(argv[++i]);
+        else if (arg == "--cluster" && tieneValor) opciones.tamanoCluster = atoi(argv[++i]);
+        else if (arg == "--replanificacion" && tieneValor) opciones.replanificacion = atoi(argv[++i]);
+        else if (arg == "--cache" && tieneValor) opciones.cache = atoi(argv[++i]);
+        else if (arg == "--guardar" && tieneValor) opciones.guardar = argv[++i];
+        else if (arg == "--binario" && tieneValor) opciones.binario = argv[++i];
+        else if (arg == "--estadisticas" && tieneValor) opciones.estadisticas = argv[++i];
+        else if (arg == "--simd" && tieneValor) {
+            opciones.simd = argv[++i];
+            NivelSimd nivel;
+            if (opciones.simd != "comparar" && !leerNivelSimd(opciones.simd, nivel)) return false;
+        }
+        else if (arg == "--espacio" && tieneValor) {
+            string modo = argv[++i];
+            if (modo != "reusado" && modo != "nuevo") return false;
+            opciones.espacioNuevo = modo == "nuevo";
+        }
+        else if (arg == "--algoritmos" && tieneValor) {
+            if (!leerVariantes(argv[++i], opciones.variantes)) return false;
+        }
+        else return false;
+    }
+    // La bateria sin --algoritmos usa todas las variantes (variantesSuite)
+    if (opciones.variantes.empty() && !opciones.suite) leerVariantes("dijkstra", opciones.variantes);
+    return opciones.columnas > 0 && opciones.filas > 0 && opciones.consultas > 0 && opciones.habitacion > 0 &&
+           (opciones.guardar.empty() || opciones.binario.empty()) &&
+           (opciones.grafo == "csr" || opciones.grafo == "implicito") &&
+           (opciones.generador == "aleatorio" || opciones.generador == "laberinto" ||
+            opciones.generador == "habitaciones");
+}
+
+template <class Mapa>
+static vector<pair<int, int>> generarConsultas(const Mapa& cuadricula, int columnas, int cantidad, unsigned semilla,
+                                               int distanciaMinima) {
+    vector<int> libres;
+    for (int i = 0; i < cuadricula.totalNodos(); i++) {
+        if (!cuadricula.esObstaculo(i)) libres.push_back(i);
+    }
+    vector<pair<int, int>> consultas;
+    if (libres.empty()) return consultas;
+
+    mt19937 generador(semilla);
+    uniform_int_distribution<size_t> elegir(0, libres.size() - 1);
+    // Con distancia minima (en celdas, Chebyshev) se descartan los pares cercanos
+    for (int intentos = 0; (int)consultas.size() < cantidad && intentos < cantidad * 1000; intentos++) {
+        int inicio = libres[elegir(generador)];
+        int meta = libres[elegir(generador)];
+        int distancia = max(abs(inicio % columnas - meta % columnas), abs(inicio / columnas - meta / columnas));
+        if (distancia >= distanciaMinima) consultas.push_back({inicio, meta});
+    }
+    return consultas;
+}
+
+// Consultas de un .scen; las escritas para un mapa de otro tamano o con un
+// extremo fuera del mapa se descartan. optimos, si no es nulo, recibe la
+// longitud optima de cada una en celdas.
+static vector<pair<int, int>> consultasDeEscenarios(const vector<ConsultaEscenario>& escenarios, int columnas,
+                                                    int filas, vector<double>* optimos) {
+    vector<pair<int, int>> consultas;
+    for (const ConsultaEscenario& e : escenarios) {
+        if (e.columnas != columnas || e.filas != filas) continue;
+        if (e.inicioX < 0 || e.inicioX >= columnas || e.metaX < 0 || e.metaX >= columnas) continue;
+        if (e.inicioY < 0 || e.inicioY >= filas || e.metaY < 0 || e.metaY >= filas) continue;
+        consultas.push_back({obtenerIndice(e.inicioX, e.inicioY, columnas), obtenerIndice(e.metaX, e.metaY, columnas)});
+        if (optimos) optimos->push_back(e.optimo);
+    }
+    return consultas;
+}
+
+// Las del .scen si hay, si no al azar.
+template <class Mapa>
+static vector<pair<int, int>> elegirConsultas(const Mapa& mapa, int columnas, int filas,
+                                              const vector<ConsultaEscenario>& escenarios, const Opciones& opciones) {
+    if (escenarios.empty()) {
+        return generarConsultas(mapa, columnas, opciones.consultas, opciones.semilla, opciones.distanciaMinima);
+    }
+    return consultasDeEscenarios(escenarios, columnas, filas, nullptr);
+}
+
+static Cuadricula generarCuadricula(const string& generador, int columnas, int filas, float espaciado,
+                                    float densidad, int habitacion, unsigned semilla) {
+    if (generador == "laberinto") return generarLaberinto(columnas, filas, espaciado, semilla);
+    if (generador == "habitaciones") return generarHabitaciones(columnas, filas, espaciado, habitacion, semilla);
+    return generarCuadriculaAleatoria(columnas, filas, espaciado, densidad, semilla);
+}
+
+static double percentil(const vector<double>& ordenadas, double p) {
+    size_t i = (size_t)(p * (ordenadas.size() - 1) + 0.5);
+    return ordenadas[min(i, ordenadas.size() - 1)];
+}
+
+template <class G>
+static Medicion medir(const G& grafo, const vector<pair<int, int>>& consultas, const OpcionesBusqueda& busqueda,
+                      bool espacioNuevo) {
+    Medicion medicion;
+    EspacioBusqueda espacioReusado;
+    vector<double> latencias;
+    latencias.reserve(consultas.size());
+    size_t expandidos = 0;
+    size_t extracciones = 0;
+    auto inicioTotal = chrono::steady_clock::now();
+    for (auto& consulta : consultas) {
+        auto t = chrono::steady_clock::now();
+        EspacioBusqueda espacioTemporal;
+        EspacioBusqueda& espacio = espacioNuevo ? espacioTemporal : espacioReusado;
+        ResultadoBusqueda resultado = buscarRuta(grafo, espacio, consulta.first, consulta.second, busqueda);
+        latencias.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - t).count());
+        if (resultado.camino.empty()) medicion.sinRuta++;
+        else medicion.costoTotal += resultado.costo;
+        medicion.costos.push_back(resultado.costo);
+        medicion.extracciones.push_back(resultado.extracciones);
+        medicion.estadisticas.push_back(resultado.estadisticas);
+        expandidos += resultado.nodosVisitados.size();
+        extracciones += resultado.extracciones;
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicioTotal).count();
+
+    sort(latencias.begin(), latencias.end());
+    medicion.consultasPorSegundo = consultas.size() / segundos;
+    medicion.p50 = percentil(latencias, 0.50);
+    medicion.p90 = percentil(latencias, 0.90);
+    medicion.p99 = percentil(latencias, 0.99);
+    medicion.maximo = latencias.back();
+    medicion.expandidosPromedio = (double)expandidos / consultas.size();
+    medicion.expansionesPorSegundo = expandidos / segundos;
+    medicion.extraccionesPromedio = (double)extracciones / consultas.size();
+    return medicion;
+}
+
+// Lote paralelo de la primera variante con 1, 2, 4... hilos.
+template <class G>
+static void medirEscalado(const G& grafo, const vector<pair<int, int>>& consultas, const Variante& variante,
+                          int maxHilos) {
+    printf("escalado del lote (%s):\n", variante.nombre.c_str());
+    printf("%6s %12s %10s %10s\n", "hilos", "consultas/s", "speedup", "eficiencia");
+    double base = 0;
+    vector<ResultadoBusqueda> referencia;
+    for (int hilos = 1; hilos <= maxHilos; hilos = hilos * 2 > maxHilos && hilos < maxHilos ? maxHilos : hilos * 2) {
+        BuscadorLote buscador(hilos);
+        buscador.resolver(grafo, consultas, variante.busqueda);  // calienta los espacios
+        auto t = chrono::steady_clock::now();
+        vector<ResultadoBusqueda> resultados = buscador.resolver(grafo, consultas, variante.busqueda);
+        double qps = consultas.size() / chrono::duration<double>(chrono::steady_clock::now() - t).count();
+        if (hilos == 1) {
+            base = qps;
+            referencia = move(resultados);
+        } else {
+            for (size_t i = 0; i < consultas.size(); i++) {
+                if (resultados[i].costo != referencia[i].costo) {
+                    printf("  aviso: la consulta %zu difiere con %d hilos\n", i, hilos);
+                    break;
+                }
+            }
+        }
+        printf("%6d %12.1f %10.2f %9.0f%%\n", hilos, qps, qps / base, 100.0 * qps / base / hilos);
+    }
+}
+
+// Matriz N x N: N*N consultas punto a punto frente a N busquedas uno-a-muchos.
+template <class G>
+static void medirMatriz(const G& grafo, const vector<pair<int, int>>& consultas, int n) {
+    n = min(n, (int)consultas.size());
+    vector<int> origenes, metas;
+    for (int i = 0; i < n; i++) {
+        origenes.push_back(consultas[i].first);
+        metas.push_back(consultas[i].second);
+    }
+
+    EspacioBusqueda espacio;
+    vector<float> porPares(n * n);
+    auto t = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) porPares[i * n + j] = dijkstra(grafo, espacio, origenes[i], metas[j]).costo;
+    }
+    double msPares = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+
+    BuscadorLote buscador;
+    t = chrono::steady_clock::now();
+    vector<float> matriz = buscador.matrizDistancias(grafo, origenes, metas);
+    double msMatriz = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+
+    t = chrono::steady_clock::now();
+    vector<int> asignadas = buscador.asignarMetasCercanas(grafo, origenes, metas);
+    double msAsignar = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+
+    int distintas = 0;
+    for (int i = 0; i < n * n; i++) distintas += matriz[i] != porPares[i];
+    for (int i = 0; i < n; i++) {
+        float minimo = *min_element(&matriz[i * n], &matriz[i * n] + n);
+        if (asignadas[i] != -1 && matriz[i * n + asignadas[i]] != minimo) distintas++;
+    }
+    printf("matriz %dx%d: por pares %.2f ms, uno-a-muchos %.2f ms (%d hilos, x%.1f), meta mas cercana %.2f ms\n",
+           n, n, msPares, msMatriz, buscador.totalHilos(), msPares / msMatriz, msAsignar);
+    if (distintas > 0) printf("  aviso: %d distancias distintas\n", distintas);
+}
+
+// Campo de distancias desde el origen de la primera consulta: Dijkstra
+// secuencial frente a delta-stepping con 1, 2, 4... hasta N hilos. Los campos
+// tienen que salir identicos, y las metas de las consultas a la misma
+// distancia que con dijkstra punto a punto.
+template <class G>
+static void medirCampo(const G& grafo, const vector<pair<int, int>>& consultas, int maxHilos, float delta) {
+    int origen = consultas[0].first;
+    CampoDistancias referencia;
+    auto t = chrono::steady_clock::now();
+    campoDistancias(grafo, origen, referencia);
+    double msSecuencial = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+
+    EspacioBusqueda espacio;
+    int distintas = 0;
+    for (const auto& consulta : consultas) {
+        float costo = dijkstra(grafo, espacio, origen, consulta.second).costo;
+        distintas += costo != referencia.distancias[consulta.second];
+    }
+    printf("campo de distancias desde %d (delta %.1f):\n", origen,
+           delta > 0 ? delta : CUBETA_POR_DEFECTO * grafo.obtenerEspaciado());
+    printf("%-16s %10s %10s\n", "hilos", "ms", "speedup");
+    printf("%-16s %10.2f %10.2f\n", "dijkstra", msSecuencial, 1.0);
+    if (distintas > 0) printf("  aviso: %d metas con distancia distinta a dijkstra punto a punto\n", distintas);
+
+    for (int hilos = 1; hilos <= maxHilos; hilos = hilos * 2 > maxHilos && hilos < maxHilos ? maxHilos : hilos * 2) {
+        GrupoHilos grupo(hilos);
+        CampoDistancias campo;
+        deltaStepping(grafo, grupo, origen, delta, campo);  // calienta los hilos
+        t = chrono::steady_clock::now();
+        deltaStepping(grafo, grupo, origen, delta, campo);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+        printf("%-16d %10.2f %10.2f\n", hilos, ms, msSecuencial / ms);
+        if (campo.distancias != referencia.distancias || campo.desde != referencia.desde) {
+            printf("  aviso: el campo difiere de dijkstra con %d hilos\n", hilos);
+        }
+    }
+}
+
+// N agentes hacia la meta de la primera consulta: una busqueda por agente
+// con la primera variante frente a un solo campo de flujo. Siguiendo el
+// campo desde cada agente se tiene que llegar a la meta con el mismo costo.
+template <class G>
+static void medirFlujo(const G& grafo, const vector<pair<int, int>>& consultas, int agentes,
+                       const Variante& variante) {
+    int meta = consultas[0].second;
+    vector<pair<int, int>> rutas;
+    for (int i = 0; i < agentes; i++) rutas.push_back({consultas[i % consultas.size()].first, meta});
+    Medicion busquedas = medir(grafo, rutas, variante.busqueda, false);
+    double msBusquedas = rutas.size() / busquedas.consultasPorSegundo * 1000;
+
+    CampoFlujo flujo;
+    auto t = chrono::steady_clock::now();
+    flujo.calcular(grafo, meta);
+    double msCampo = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+    GrupoHilos hilos;
+    flujo.calcular(grafo, meta, &hilos);  // calienta los hilos
+    t = chrono::steady_clock::now();
+    flujo.calcular(grafo, meta, &hilos);
+    double msParalelo = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+
+    int distintas = 0;
+    for (size_t i = 0; i < rutas.size(); i++) {
+        float costo = 0;
+        int pasos = 0;
+        for (int nodo = rutas[i].first; flujo.siguiente(nodo) != -1 && pasos <= grafo.totalNodos(); pasos++) {
+            int siguiente = flujo.siguiente(nodo);
+            grafo.paraCadaVecino(nodo, [&](int vecino, float c) {
+                if (vecino == siguiente) costo += c;
+            });
+            nodo = siguiente;
+        }
+        float esperado = busquedas.costos[i];
+        if (pasos == 0 && rutas[i].first != meta) costo = INFINITO;
+        if (costo != esperado && !(fabs(costo - esperado) <= 1e-4f * max(costo, esperado))) distintas++;
+    }
+    printf("flujo: %d agentes hacia %d, %s %.2f ms, campo %.2f ms (x%.1f), con %d hilos %.2f ms, %.1f MB\n",
+           agentes, meta, variante.nombre.c_str(), msBusquedas, msCampo, msBusquedas / msCampo,
+           hilos.totalHilos(), msParalelo, flujo.bytes() / 1048576.0);
+    if (distintas > 0) printf("  aviso: %d agentes con costo distinto a la busqueda\n", distintas);
+}
+
+// Busquedas en segundo plano con la primera variante. Cada consulta se pide
+// justo despues de otra que queda reemplazada: solo tiene que llegar la
+// segunda, con el mismo costo que la sincrona y sin esperar a que termine la
+// primera. Despues se mide cuanto tarda cancelar() una busqueda en curso.
+template <class G>
+static void medirAsincrono(const G& grafo, const vector<pair<int, int>>& consultas, const Variante& variante) {
+    Medicion sincrona = medir(grafo, consultas, variante.busqueda, false);
+    BuscadorAsincrono buscador;
+    int distintas = 0;
+    double msTotal = 0;
+    for (size_t i = 0; i < consultas.size(); i++) {
+        const auto& reemplazada = consultas[(i + 1) % consultas.size()];
+        auto t = chrono::steady_clock::now();
+        buscador.solicitar(grafo, reemplazada.first, reemplazada.second, variante.busqueda);
+        uint64_t esperada = buscador.solicitar(grafo, consultas[i].first, consultas[i].second, variante.busqueda);
+        ResultadoBusqueda resultado;
+        uint64_t recibida = 0;
+        while (!buscador.recoger(resultado, &recibida)) this_thread::yield();
+        msTotal += chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+        distintas += recibida != esperada || resultado.costo != sincrona.costos[i];
+    }
+
+    double msCancelacion = 0, maximo = 0;
+    for (const auto& consulta : consultas) {
+        buscador.solicitar(grafo, consulta.first, consulta.second, variante.busqueda);
+        this_thread::sleep_for(chrono::milliseconds(1));  // que la busqueda este en curso
+        auto t = chrono::steady_clock::now();
+        buscador.cancelar();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+        msCancelacion += ms;
+        maximo = max(maximo, ms);
+    }
+    ResultadoBusqueda sobrante;
+    if (buscador.recoger(sobrante)) distintas++;
+
+    printf("asincrono (%s): %.3f ms por consulta reemplazando otra (sincrona %.3f ms), "
+           "cancelacion %.3f ms media, %.3f ms maxima\n", variante.nombre.c_str(), msTotal / consultas.size(),
+           1000 / sincrona.consultasPorSegundo, msCancelacion / consultas.size(), maximo);
+    if (distintas > 0) printf("  aviso: %d consultas con resultado distinto o entregado de mas\n", distintas);
+}
+
+// Cada consulta repartida en llamadas de como mucho microsegundos, con
+// Dijkstra o con A* si la primera variante es A*. Interesa cuanto dura la
+// llamada mas larga (el costo por cuadro) y que el costo sea el de la
+// busqueda de una sola vez.
+template <class G>
+static void medirPasos(const G& grafo, const vector<pair<int, int>>& consultas, int microsegundos,
+                       const Variante& variante) {
+    OpcionesBusqueda opciones;
+    float peso = 0;
+    if (variante.busqueda.algoritmo == Algoritmo::AEstrella) {
+        opciones = variante.busqueda;
+        opciones.cola = TipoCola::Binaria;
+        peso = opciones.peso;
+    }
+    Medicion completa = medir(grafo, consultas, opciones, false);
+
+    EspacioBusqueda espacio;
+    BusquedaPorPasos<G> busqueda(grafo, espacio);
+    vector<double> llamadas;
+    int distintas = 0;
+    auto inicio = chrono::steady_clock::now();
+    for (size_t i = 0; i < consultas.size(); i++) {
+        busqueda.iniciar(consultas[i].first, consultas[i].second, peso, opciones.heuristica);
+        bool terminada = false;
+        while (!terminada) {
+            auto t = chrono::steady_clock::now();
+            terminada = busqueda.avanzarDurante(microsegundos);
+            llamadas.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - t).count());
+        }
+        float a = busqueda.obtenerResultado().costo, b = completa.costos[i];
+        if (a != b && !(fabs(a - b) <= 1e-4f * max(a, b))) distintas++;
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    sort(llamadas.begin(), llamadas.end());
+    printf("por pasos de %d us (%s): %.1f llamadas por consulta, p50 %.1f us, p99 %.1f us, maxima %.1f us, "
+           "%.1f consultas/s (de una vez %.1f)\n", microsegundos, peso > 0 ? variante.nombre.c_str() : "dijkstra",
+           (double)llamadas.size() / consultas.size(), percentil(llamadas, 0.5), percentil(llamadas, 0.99),
+           llamadas.back(), consultas.size() / segundos, completa.consultasPorSegundo);
+    if (distintas > 0) printf("  aviso: %d consultas con costo distinto a la busqueda de una vez\n", distintas);
+}
+
+// Las variantes "ch" comparten una jerarquia que se construye una sola vez,
+// o se lee del archivo binario si la trae.
+template <class G>
+static unique_ptr<JerarquiaContraccion> prepararContraccion(const G& grafo, vector<Variante>& variantes,
+                                                            const ArchivoMapa& archivo) {
+    unique_ptr<JerarquiaContraccion> jerarquia;
+    for (auto& variante : variantes) {
+        if (variante.busqueda.algoritmo != Algoritmo::Contraccion) continue;
+        if (!jerarquia) {
+            auto t0 = chrono::steady_clock::now();
+            bool leida = archivo.abierto() && archivo.tieneContraccion();
+            jerarquia.reset(leida ? new JerarquiaContraccion(archivo.copiarContraccion())
+                                  : new JerarquiaContraccion(copiarAristas(grafo)));
+            printf("contraccion: %d atajos, %d aristas, %.1f MB, %s: %.2f ms\n", jerarquia->totalAtajos(),
+                   jerarquia->totalAristas(), jerarquia->bytes() / 1048576.0, leida ? "lectura" : "construccion",
+                   chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+        }
+        variante.busqueda.contraccion = jerarquia.get();
+    }
+    return jerarquia;
+}
+
+// Alterna celdas al azar y rehace solo los clusters afectados; cada celda se
+// alterna dos veces para dejar el mapa como estaba.
+static void medirActualizacionJerarquia(GrafoCuadricula& grafo, MapaJerarquico& jerarquia, unsigned semilla) {
+    const int CELDAS = 100;
+    mt19937 generador(semilla);
+    uniform_int_distribution<int> distribucion(0, grafo.totalNodos() - 1);
+    auto t = chrono::steady_clock::now();
+    for (int i = 0; i < CELDAS; i++) {
+        int celda = distribucion(generador);
+        for (int vez = 0; vez < 2; vez++) {
+            grafo.alternarObstaculo(celda);
+            jerarquia.actualizarCelda(celda);
+        }
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+    printf("jerarquia: actualizacion de celda %.3f ms\n", ms / (2 * CELDAS));
+}
+
+// Un agente recorre su ruta y cada pocos pasos aparece un obstaculo delante:
+// D* Lite repara la ruta anterior frente a A* desde cero en cada paso.
+static void medirReplanificacion(GrafoCuadricula grafo, const vector<pair<int, int>>& consultas, int pasos) {
+    const int AVANCE = 4;
+    const int ADELANTO = 8;
+    PlanificadorIncremental planificador(grafo);
+    EspacioBusqueda espacio;
+    OpcionesBusqueda aEstrella;
+    aEstrella.algoritmo = Algoritmo::AEstrella;
+
+    double msInicial = 0, msIncremental = 0, msDesdeCero = 0;
+    long nodosIncremental = 0, nodosDesdeCero = 0;
+    int replanificaciones = 0, distintas = 0;
+    for (int q = 0; q < (int)consultas.size() && replanificaciones < pasos; q++) {
+        int agente = consultas[q].first;
+        int meta = consultas[q].second;
+        auto t = chrono::steady_clock::now();
+        planificador.iniciar(agente, meta);
+        ResultadoBusqueda ruta = planificador.planificar();
+        msInicial += chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+
+        while (replanificaciones < pasos && (int)ruta.camino.size() > AVANCE + ADELANTO) {
+            agente = ruta.camino[AVANCE];
+            int bloqueada = ruta.camino[AVANCE + ADELANTO];
+            if (bloqueada == meta) break;
+            grafo.alternarObstaculo(bloqueada);
+
+            t = chrono::steady_clock::now();
+            planificador.moverInicio(agente);
+            planificador.notificarCambio(bloqueada);
+            ruta = planificador.planificar();
+            msIncremental += chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+            nodosIncremental += ruta.nodosVisitados.size();
+
+            t = chrono::steady_clock::now();
+            ResultadoBusqueda desdeCero = buscarRuta(grafo, espacio, agente, meta, aEstrella);
+            msDesdeCero += chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+            nodosDesdeCero += desdeCero.nodosVisitados.size();
+
+            float a = ruta.costo, b = desdeCero.costo;
+            if (a != b && !(fabs(a - b) <= 1e-4f * max(a, b))) distintas++;
+            replanificaciones++;
+        }
+    }
+    if (replanificaciones == 0) return;
+    printf("replanificacion: %d pasos, planificacion inicial %.2f ms en total\n", replanificaciones, msInicial);
+    printf("  d* lite:          %8.3f ms/paso %10.1f nodos/paso\n", msIncremental / replanificaciones,
+           (double)nodosIncremental / replanificaciones);
+    printf("  aestrella (cero): %8.3f ms/paso %10.1f nodos/paso\n", msDesdeCero / replanificaciones,
+           (double)nodosDesdeCero / replanificaciones);
+    if (distintas > 0) printf("  aviso: %d replanificaciones con costo distinto a A*\n", distintas);
+}
+
+// Agentes que repiten consultas mientras se editan obstaculos: la mitad
+// repite uno de los pares frecuentes, un cuarto lo retoma desde un punto de
+// su ultima ruta y el resto es un par cualquiera; cada EDICION_CADA
+// consultas se alterna una celda al azar. Cada consulta se resuelve con la
+// cache y tambien buscando, para medir ambas y comparar los costos.
+static void medirCache(GrafoCuadricula grafo, const vector<pair<int, int>>& consultas, const Variante& variante,
+                       int capacidad, unsigned semilla) {
+    const int EDICION_CADA = 20;
+    const size_t FRECUENTES = 32;
+    OpcionesBusqueda busqueda = variante.busqueda;
+    string nombre = variante.nombre;
+    // Lo preprocesado quedaria desactualizado con las ediciones
+    if (busqueda.algoritmo == Algoritmo::JPSMas || busqueda.algoritmo == Algoritmo::Jerarquico ||
+        busqueda.algoritmo == Algoritmo::Contraccion) {
+        busqueda = OpcionesBusqueda();
+        busqueda.algoritmo = Algoritmo::AEstrella;
+        nombre = "aestrella";
+    }
+    CacheRutas cache(grafo, capacidad);
+    EspacioBusqueda espacio;
+    mt19937 generador(semilla);
+    uniform_real_distribution<float> azar(0, 1);
+    uniform_int_distribution<int> celda(0, grafo.totalNodos() - 1);
+    size_t frecuentes = min(FRECUENTES, consultas.size());
+    vector<vector<int>> ultimaRuta(frecuentes);
+
+    int total = 4 * (int)consultas.size();
+    double msCache = 0, msBusqueda = 0;
+    int ediciones = 0, distintas = 0;
+    for (int q = 0; q < total; q++) {
+        if (q > 0 && q % EDICION_CADA == 0) {
+            int nodo = celda(generador);
+            grafo.alternarObstaculo(nodo);
+            cache.notificarCambio(nodo, grafo.esObstaculo(nodo));
+            ediciones++;
+        }
+        float tipo = azar(generador);
+        size_t elegido = generador() % frecuentes;
+        int inicio = consultas[elegido].first;
+        int meta = consultas[elegido].second;
+        if (tipo >= 0.75f) {
+            tie(inicio, meta) = consultas[generador() % consultas.size()];
+        } else if (tipo >= 0.5f && !ultimaRuta[elegido].empty()) {
+            inicio = ultimaRuta[elegido][generador() % ultimaRuta[elegido].size()];
+        }
+
+        auto t = chrono::steady_clock::now();
+        ResultadoBusqueda conCache;
+        if (!cache.buscar(inicio, meta, conCache)) {
+            conCache = buscarRuta(grafo, espacio, inicio, meta, busqueda);
+            cache.guardar(inicio, meta, conCache);
+        }
+        auto t1 = chrono::steady_clock::now();
+        ResultadoBusqueda desdeCero = buscarRuta(grafo, espacio, inicio, meta, busqueda);
+        auto t2 = chrono::steady_clock::now();
+        msCache += chrono::duration<double, milli>(t1 - t).count();
+        msBusqueda += chrono::duration<double, milli>(t2 - t1).count();
+
+        float a = conCache.costo, b = desdeCero.costo;
+        if (a != b && !(fabs(a - b) <= 1e-4f * max(a, b))) distintas++;
+        if (tipo < 0.75f && inicio == consultas[elegido].first) ultimaRuta[elegido] = conCache.camino;
+    }
+
+    const CacheRutas::Estadisticas& e = cache.obtenerEstadisticas();
+    printf("cache de rutas (%s, capacidad %d): %d consultas, %d ediciones\n", nombre.c_str(), capacidad, total,
+           ediciones);
+    printf("  aciertos %.1f%% (tramos %.1f%%), invalidadas %lld, desalojadas %lld, %zu rutas, %.1f KB\n",
+           100 * e.tasaAciertos(), 100.0 * e.parciales / max(e.consultas, 1LL), e.invalidadas, e.desalojadas,
+           cache.tamano(), cache.bytes() / 1024.0);
+    printf("  con cache: %8.2f us/consulta   sin cache: %8.2f us/consulta   (x%.2f)\n", 1000 * msCache / total,
+           1000 * msBusqueda / total, msBusqueda / max(msCache, 1e-9));
+    if (distintas > 0) printf("  aviso: %d consultas con costo distinto a buscar de nuevo\n", distintas);
+}
+
+// La primera variante con cada nivel de relajacion vectorial que tenga la
+// CPU; las rutas tienen que salir iguales en todos.
+static void medirSimd(const GrafoCuadricula& grafo, const vector<pair<int, int>>& consultas,
+                      const Variante& variante) {
+    NivelSimd original = nivelSimdActual();
+    printf("relajacion de vecinos (%s):\n", variante.nombre.c_str());
+    Medicion referencia;
+    for (int n = 0; n <= (int)nivelSimdDisponible(); n++) {
+        NivelSimd nivel = elegirNivelSimd((NivelSimd)n);
+        Medicion medicion = medir(grafo, consultas, variante.busqueda, false);
+        if (n == 0) referencia = medicion;
+        printf("  %-8s %8.2f Mexp/s %10.1f consultas/s  x%.2f%s\n", nombreNivelSimd(nivel),
+               medicion.expansionesPorSegundo / 1e6, medicion.consultasPorSegundo,
+               medicion.expansionesPorSegundo / referencia.expansionesPorSegundo,
+               medicion.costos == referencia.costos ? "" : "  aviso: costos distintos");
+    }
+    elegirNivelSimd(original);
+}
+
+// Promedio por consulta de los contadores de cada variante (la cola, el maximo).
+static void mostrarContadores(const vector<Variante>& variantes, const vector<Medicion>& mediciones) {
+    printf("%-28s %12s %12s %12s %12s %10s %10s\n", "contadores", "expandidos", "aristas", "inserciones",
+           "obsoletas", "cola max", "KB");
+    for (size_t i = 0; i < variantes.size(); i++) {
+        EstadisticasBusqueda suma;
+        double bytes = 0;
+        for (const auto& estadisticas : mediciones[i].estadisticas) {
+            suma.acumular(estadisticas);
+            bytes += estadisticas.bytes;
+        }
+        double n = max((double)mediciones[i].estadisticas.size(), 1.0);
+        printf("%-28s %12.1f %12.1f %12.1f %12.1f %10lld %10.1f\n", variantes[i].nombre.c_str(),
+               suma.expandidos / n, suma.aristas / n, suma.inserciones / n, suma.obsoletas / n, suma.colaMaxima,
+               bytes / n / 1024);
+    }
+}
+
+// Una fila por consulta y variante; CSV si el archivo termina en .csv, si no JSON.
+static bool escribirEstadisticas(const string& ruta, const vector<pair<int, int>>& consultas,
+                                 const vector<Variante>& variantes, const vector<Medicion>& mediciones) {
+    FILE* archivo = fopen(ruta.c_str(), "w");
+    if (!archivo) {
+        fprintf(stderr, "no se pudo escribir %s\n", ruta.c_str());
+        return false;
+    }
+    bool csv = ruta.size() >= 4 && ruta.compare(ruta.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        fprintf(archivo, "variante,consulta,inicio,meta,costo,extracciones,expandidos,aristas,inserciones,"
+                         "obsoletas,cola_maxima,microsegundos,bytes\n");
+    } else {
+        fprintf(archivo, "{\"estadisticas_activas\": %s, \"consultas\": [\n", ESTADISTICAS_ACTIVAS ? "true" : "false");
+    }
+    bool primera = true;
+    for (size_t v = 0; v < variantes.size(); v++) {
+        const Medicion& medicion = mediciones[v];
+        for (size_t c = 0; c < consultas.size(); c++) {
+            const EstadisticasBusqueda& e = medicion.estadisticas[c];
+            // Sin ruta el costo es infinito: null en JSON, vacio en CSV
+            char costo[32] = "";
+            if (medicion.costos[c] != INFINITO) snprintf(costo, sizeof(costo), "%.9g", medicion.costos[c]);
+            else if (!csv) snprintf(costo, sizeof(costo), "null");
+            if (csv) {
+                fprintf(archivo, "%s,%zu,%d,%d,%s,%d,%lld,%lld,%lld,%lld,%lld,%.3f,%lld\n", variantes[v].nombre.c_str(),
+                        c, consultas[c].first, consultas[c].second, costo, medicion.extracciones[c], e.expandidos,
+                        e.aristas, e.inserciones, e.obsoletas, e.colaMaxima, e.microsegundos, e.bytes);
+            } else {
+                fprintf(archivo, "%s  {\"variante\": \"%s\", \"consulta\": %zu, \"inicio\": %d, \"meta\": %d, "
+                                 "\"costo\": %s, \"extracciones\": %d, \"expandidos\": %lld, \"aristas\": %lld, "
+                                 "\"inserciones\": %lld, \"obsoletas\": %lld, \"cola_maxima\": %lld, "
+                                 "\"microsegundos\": %.3f, \"bytes\": %lld}",
+                        primera ? "" : ",\n", variantes[v].nombre.c_str(), c, consultas[c].first, consultas[c].second,
+                        costo, medicion.extracciones[c], e.expandidos, e.aristas, e.inserciones, e.obsoletas,
+                        e.colaMaxima, e.microsegundos, e.bytes);
+            }
+            primera = false;
+        }
+    }
+    if (!csv) fprintf(archivo, "\n]}\n");
+    bool correcto = !ferror(archivo);
+    correcto = fclose(archivo) == 0 && correcto;
+    if (!correcto) fprintf(stderr, "error al escribir %s\n", ruta.c_str());
+    return correcto;
+}
+
+// La primera variante es la referencia para las columnas relativas.
+template <class G>
+static int ejecutarVariantes(const G& grafo, const vector<pair<int, int>>& consultas, const vector<Variante>& variantes,
+                             bool espacioNuevo, int escalado, int matriz, int campo, float delta,
+                             int agentes, bool asincrono, int pasos, const string& archivoEstadisticas) {
+    printf("consultas: %zu\n", consultas.size());
+    printf("%-28s %10s %10s %10s %10s %12s %12s %8s %8s %8s\n", "variante", "consultas/s", "p50 us", "p90 us",
+           "p99 us", "expandidos", "extraccion", "Mexp/s", "x ref", "costo");
+    Medicion referencia;
+    vector<Medicion> mediciones;
+    for (size_t i = 0; i < variantes.size(); i++) {
+        mediciones.push_back(medir(grafo, consultas, variantes[i].busqueda, espacioNuevo));
+        const Medicion& medicion = mediciones.back();
+        if (i == 0) referencia = medicion;
+        printf("%-28s %10.1f %10.1f %10.1f %10.1f %12.1f %12.1f %8.2f %8.3f %8.4f\n",
+               variantes[i].nombre.c_str(), medicion.consultasPorSegundo, medicion.p50, medicion.p90, medicion.p99,
+               medicion.expandidosPromedio, medicion.extraccionesPromedio, medicion.expansionesPorSegundo / 1e6,
+               medicion.expandidosPromedio / max(referencia.expandidosPromedio, 1.0),
+               medicion.costoTotal / max(referencia.costoTotal, 1e-9));
+        int distintas = 0;
+        for (size_t c = 0; c < consultas.size(); c++) {
+            float a = medicion.costos[c], b = referencia.costos[c];
+            if (a != b && !(fabs(a - b) <= 1e-4f * max(a, b))) distintas++;
+        }
+        if (distintas > 0) {
+            printf("  aviso: %d consultas con costo distinto a la referencia\n", distintas);
+        }
+    }
+    if (ESTADISTICAS_ACTIVAS) mostrarContadores(variantes, mediciones);
+    if (!archivoEstadisticas.empty()) {
+        if (!ESTADISTICAS_ACTIVAS) fprintf(stderr, "aviso: compilado sin estadisticas, los contadores salen en 0\n");
+        if (!escribirEstadisticas(archivoEstadisticas, consultas, variantes, mediciones)) return 1;
+    }
+    if (escalado > 0) medirEscalado(grafo, consultas, variantes[0], escalado);
+    if (matriz > 0) medirMatriz(grafo, consultas, matriz);
+    if (campo > 0) medirCampo(grafo, consultas, campo, delta);
+    if (agentes > 0) medirFlujo(grafo, consultas, agentes, variantes[0]);
+    if (asincrono) medirAsincrono(grafo, consultas, variantes[0]);
+    if (pasos > 0) medirPasos(grafo, consultas, pasos, variantes[0]);
+    return 0;
+}
+
+// Bateria (--suite): cada escenario es un mapa con sus consultas, y cada
+// variante se compara con dijkstra sobre la cola binaria.
+struct EscenarioSuite {
+    string nombre;
+    GrafoCuadricula grafo;
+    vector<pair<int, int>> consultas;
+    vector<double> optimos;  // del .scen, en celdas
+};
+
+struct FilaSuite {
+    string escenario;
+    string variante;
+    int nodos = 0;
+    size_t consultas = 0;
+    double msPreparacion = 0;
+    Medicion medicion;
+    double costoRelativo = 0;  // suma de costos frente a la de la referencia
+    int distintas = 0;         // consultas fuera de lo que garantiza la variante
+};
+
+// La contraccion tarda demasiado en construirse por encima de este tamano;
+// sin --algoritmos se omite.
+const int LIMITE_CONTRACCION = 1 << 16;
+
+static vector<Variante> variantesSuite() {
+    vector<Variante> variantes;
+    leerVariantes("dijkstra@binaria,dijkstra@cuaternaria,dijkstra@radix,aestrella@binaria,aestrella@cuaternaria,"
+                  "aestrella@radix,aestrella:euclidiana,aestrella:octil:1.5,jps,jps+,dijkstra-bi,aestrella-bi,"
+                  "hpa,ch", variantes);
+    return variantes;
+}
+
+static vector<string> separar(const string& lista, char separador) {
+    vector<string> partes;
+    stringstream flujo(lista);
+    for (string parte; getline(flujo, parte, separador);) {
+        if (!parte.empty()) partes.push_back(parte);
+    }
+    return partes;
+}
+
+// A* ponderado puede costar hasta peso veces el optimo y HPA* no tiene
+// cota; todas tienen que encontrar ruta cuando la referencia la encuentra.
+static bool costoAceptable(const OpcionesBusqueda& busqueda, float costo, float referencia) {
+    if (costo == INFINITO || referencia == INFINITO) return costo == referencia;
+    if (busqueda.algoritmo == Algoritmo::Jerarquico) return costo >= referencia * (1 - 1e-4f);
+    float cota = busqueda.algoritmo == Algoritmo::AEstrella ? max(busqueda.peso, 1.f) * referencia : referencia;
+    return costo <= cota * (1 + 1e-4f) && costo >= referencia * (1 - 1e-4f);
+}
+
+static void medirEscenario(const EscenarioSuite& escenario, const vector<Variante>& pedidas, bool todas,
+                           int tamanoCluster, vector<FilaSuite>& filas) {
+    const GrafoCuadricula& grafo = escenario.grafo;
+    printf("\n%s: %dx%d, %zu consultas\n", escenario.nombre.c_str(), grafo.obtenerColumnas(),
+           grafo.obtenerFilas(), escenario.consultas.size());
+    Medicion referencia = medir(grafo, escenario.consultas, OpcionesBusqueda(), false);
+    if (!escenario.optimos.empty()) {
+        // Los .scen no permiten cortar esquinas y aqui si: la referencia puede ser menor
+        int iguales = 0;
+        for (size_t i = 0; i < escenario.optimos.size(); i++) {
+            double celdas = referencia.costos[i] / grafo.obtenerEspaciado();
+            iguales += fabs(celdas - escenario.optimos[i]) <= 1e-3 * max(1.0, escenario.optimos[i]);
+        }
+        printf("  referencia igual al optimo del .scen en %d de %zu consultas (el .scen no corta esquinas)\n",
+               iguales, escenario.optimos.size());
+    }
+
+    printf("  %-24s %10s %11s %10s %10s %12s %10s %8s %6s\n", "variante", "prep ms", "consultas/s", "p50 us",
+           "p99 us", "expandidos", "extraccion", "costo", "mal");
+    unique_ptr<TablaSaltos> tabla;
+    unique_ptr<MapaJerarquico> jerarquia;
+    unique_ptr<JerarquiaContraccion> contraccion;
+    for (Variante variante : pedidas) {
+        FilaSuite fila;
+        fila.escenario = escenario.nombre;
+        fila.variante = variante.nombre;
+        fila.nodos = grafo.totalNodos();
+        fila.consultas = escenario.consultas.size();
+        auto t = chrono::steady_clock::now();
+        switch (variante.busqueda.algoritmo) {
+            case Algoritmo::JPSMas:
+                if (!tabla) tabla.reset(new TablaSaltos(grafo));
+                variante.busqueda.tablaSaltos = tabla.get();
+                break;
+            case Algoritmo::Jerarquico:
+                if (!jerarquia) jerarquia.reset(new MapaJerarquico(grafo, tamanoCluster));
+                variante.busqueda.jerarquia = jerarquia.get();
+                break;
+            case Algoritmo::Contraccion:
+                if (todas && grafo.totalNodos() > LIMITE_CONTRACCION) {
+                    printf("  %-24s omitida: mas de %d nodos\n", variante.nombre.c_str(), LIMITE_CONTRACCION);
+                    continue;
+                }
+                if (!contraccion) contraccion.reset(new JerarquiaContraccion(copiarAristas(grafo)));
+                variante.busqueda.contraccion = contraccion.get();
+                break;
+            default:
+                break;
+        }
+        fila.msPreparacion = chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+
+        fila.medicion = medir(grafo, escenario.consultas, variante.busqueda, false);
+        const Medicion& medicion = fila.medicion;
+        for (size_t i = 0; i < escenario.consultas.size(); i++) {
+            fila.distintas += !costoAceptable(variante.busqueda, medicion.costos[i], referencia.costos[i]);
+        }
+        fila.costoRelativo = medicion.costoTotal / max(referencia.costoTotal, 1e-9);
+        printf("  %-24s %10.2f %11.1f %10.1f %10.1f %12.1f %10.1f %8.4f %6d\n", variante.nombre.c_str(),
+               fila.msPreparacion, medicion.consultasPorSegundo, medicion.p50, medicion.p99,
+               medicion.expandidosPromedio, medicion.extraccionesPromedio, fila.costoRelativo, fila.distintas);
+        filas.push_back(move(fila));
+    }
+}
+
+static bool escribirSuite(const string& ruta, const vector<FilaSuite>& filas) {
+    FILE* archivo = fopen(ruta.c_str(), "w");
+    if (!archivo) {
+        fprintf(stderr, "no se pudo escribir %s\n", ruta.c_str());
+        return false;
+    }
+    bool csv = ruta.size() >= 4 && ruta.compare(ruta.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        fprintf(archivo, "escenario,variante,nodos,consultas,preparacion_ms,consultas_por_segundo,p50_us,p90_us,"
+                         "p99_us,maximo_us,expandidos,extracciones,costo_relativo,sin_ruta,distintas\n");
+    } else {
+        fprintf(archivo, "{\"resultados\": [\n");
+    }
+    for (size_t i = 0; i < filas.size(); i++) {
+        const FilaSuite& f = filas[i];
+        const Medicion& m = f.medicion;
+        if (csv) {
+            fprintf(archivo, "%s,%s,%d,%zu,%.3f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.6f,%d,%d\n",
+                    f.escenario.c_str(), f.variante.c_str(), f.nodos, f.consultas, f.msPreparacion,
+                    m.consultasPorSegundo, m.p50, m.p90, m.p99, m.maximo, m.expandidosPromedio,
+                    m.extraccionesPromedio, f.costoRelativo, m.sinRuta, f.distintas);
+        } else {
+            fprintf(archivo, "  {\"escenario\": \"%s\", \"variante\": \"%s\", \"nodos\": %d, \"consultas\": %zu, "
+                             "\"preparacion_ms\": %.3f, \"consultas_por_segundo\": %.1f, \"p50_us\": %.1f, "
+                             "\"p90_us\": %.1f, \"p99_us\": %.1f, \"maximo_us\": %.1f, \"expandidos\": %.1f, "
+                             "\"extracciones\": %.1f, \"costo_relativo\": %.6f, \"sin_ruta\": %d, "
+                             "\"distintas\": %d}%s\n",
+                    f.escenario.c_str(), f.variante.c_str(), f.nodos, f.consultas, f.msPreparacion,
+                    m.consultasPorSegundo, m.p50, m.p90, m.p99, m.maximo, m.expandidosPromedio,
+                    m.extraccionesPromedio, f.costoRelativo, m.sinRuta, f.distintas, i + 1 < filas.size() ? "," : "");
+        }
+    }
+    if (!csv) fprintf(archivo, "]}\n");
+    bool correcto = !ferror(archivo);
+    correcto = fclose(archivo) == 0 && correcto;
+    if (!correcto) fprintf(stderr, "error al escribir %s\n", ruta.c_str());
+    return correcto;
+}
+
+// Compara el p50 con el de un .csv anterior de la bateria; devuelve cuantas
+// filas empeoraron mas que la tolerancia, o -1 si no se pudo leer.
+static int compararConBase(const string& ruta, const vector<FilaSuite>& filas, float tolerancia) {
+    ifstream archivo(ruta);
+    string linea;
+    if (!archivo || !getline(archivo, linea)) {
+        fprintf(stderr, "no se pudo leer la base %s\n", ruta.c_str());
+        return -1;
+    }
+    vector<string> columnas = separar(linea, ',');
+    auto posicion = [&](const string& nombre) {
+        return (int)(find(columnas.begin(), columnas.end(), nombre) - columnas.begin());
+    };
+    int escenario = posicion("escenario"), variante = posicion("variante"), p50 = posicion("p50_us");
+    if (p50 >= (int)columnas.size() || escenario >= (int)columnas.size() || variante >= (int)columnas.size()) {
+        fprintf(stderr, "%s no es un .csv de la bateria\n", ruta.c_str());
+        return -1;
+    }
+    vector<pair<string, double>> base;
+    while (getline(archivo, linea)) {
+        vector<string> campos = separar(linea, ',');
+        if ((int)campos.size() < (int)columnas.size()) continue;
+        base.push_back({campos[escenario] + "," + campos[variante], atof(campos[p50].c_str())});
+    }
+
+    int peores = 0, comparadas = 0;
+    for (const FilaSuite& fila : filas) {
+        string clave = fila.escenario + "," + fila.variante;
+        auto anterior =
+            find_if(base.begin(), base.end(), [&](const pair<string, double>& b) { return b.first == clave; });
+        if (anterior == base.end() || anterior->second <= 0) continue;
+        comparadas++;
+        double cambio = fila.medicion.p50 / anterior->second - 1;
+        if (cambio > tolerancia) {
+            printf("  regresion: %s %s p50 %.1f us, antes %.1f us (%+.0f%%)\n", fila.escenario.c_str(),
+                   fila.variante.c_str(), fila.medicion.p50, anterior->second, 100 * cambio);
+            peores++;
+        }
+    }
+    printf("base %s: %d filas comparadas, %d con el p50 mas de %.0f%% peor\n", ruta.c_str(), comparadas, peores,
+           100 * tolerancia);
+    return peores;
+}
+
+// Devuelve 1 si alguna variante dio costos fuera de su garantia, si hubo
+// regresiones frente a la base o si no se pudo leer o escribir algo.
+static int ejecutarSuite(const Opciones& opciones) {
+    bool todas = opciones.variantes.empty();
+    vector<Variante> variantes = todas ? variantesSuite() : opciones.variantes;
+    vector<EscenarioSuite> escenarios;
+    char nombre[96];
+    for (const string& texto : separar(opciones.tamanos, ',')) {
+        int lado = atoi(texto.c_str());
+        if (lado <= 0) continue;
+        for (const string& densidad : separar(opciones.densidades, ',')) {
+            snprintf(nombre, sizeof(nombre), "aleatorio-%s-%dx%d", densidad.c_str(), lado, lado);
+            escenarios.push_back({nombre, generarGrafoCuadriculaAleatorio(lado, lado, opciones.espaciado,
+                                                                          (float)atof(densidad.c_str()),
+                                                                          opciones.semilla), {}, {}});
+        }
+        snprintf(nombre, sizeof(nombre), "laberinto-%dx%d", lado, lado);
+        escenarios.push_back({nombre, GrafoCuadricula(generarLaberinto(lado, lado, opciones.espaciado,
+                                                                       opciones.semilla)), {}, {}});
+        snprintf(nombre, sizeof(nombre), "habitaciones-%d-%dx%d", opciones.habitacion, lado, lado);
+        escenarios.push_back({nombre, GrafoCuadricula(generarHabitaciones(lado, lado, opciones.espaciado,
+                                                                          opciones.habitacion, opciones.semilla)),
+                              {}, {}});
+    }
+    for (EscenarioSuite& escenario : escenarios) {
+        escenario.consultas = generarConsultas(escenario.grafo, escenario.grafo.obtenerColumnas(), opciones.consultas,
+                                               opciones.semilla, opciones.distanciaMinima);
+    }
+
+    // Mapas de MovingAI, con las consultas de su .scen si esta al lado
+    for (const string& ruta : separar(opciones.mapa, ',')) {
+        Cuadricula cuadricula;
+        if (!cargarMapa(ruta, opciones.espaciado, cuadricula)) {
+            fprintf(stderr, "no se pudo leer el mapa %s\n", ruta.c_str());
+            return 1;
+        }
+        EscenarioSuite escenario{ruta.substr(ruta.find_last_of("/\\") + 1), GrafoCuadricula(cuadricula), {}, {}};
+        vector<ConsultaEscenario> lineas;
+        if (cargarEscenarios(ruta + ".scen", lineas)) {
+            escenario.consultas = consultasDeEscenarios(lineas, cuadricula.columnas, cuadricula.filas,
+                                                        &escenario.optimos);
+        } else {
+            escenario.consultas = generarConsultas(escenario.grafo, cuadricula.columnas, opciones.consultas,
+                                                   opciones.semilla, opciones.distanciaMinima);
+        }
+        escenarios.push_back(move(escenario));
+    }
+    if (escenarios.empty()) {
+        fprintf(stderr, "la bateria no tiene escenarios\n");
+        return 1;
+    }
+
+    printf("bateria: %zu escenarios, %zu variantes, semilla %u\n", escenarios.size(), variantes.size(),
+           opciones.semilla);
+    vector<FilaSuite> filas;
+    for (const EscenarioSuite& escenario : escenarios) {
+        if (escenario.consultas.empty()) {
+            printf("\n%s: sin consultas, se omite\n", escenario.nombre.c_str());
+            continue;
+        }
+        medirEscenario(escenario, variantes, todas, opciones.tamanoCluster, filas);
+    }
+
+    int estado = 0;
+    int malas = 0;
+    for (const FilaSuite& fila : filas) malas += fila.distintas > 0;
+    if (malas > 0) {
+        printf("\naviso: %d filas con costos distintos a la referencia\n", malas);
+        estado = 1;
+    }
+    if (!opciones.salida.empty() && !escribirSuite(opciones.salida, filas)) estado = 1;
+    if (!opciones.base.empty() && compararConBase(opciones.base, filas, opciones.tolerancia) != 0) estado = 1;
+    return estado;
+}
+
+int main(int argc, char** argv) {
+    Opciones opciones;
+    if (!leerOpciones(argc, argv, opciones)) {
+        mostrarUso();
+        return 1;
+    }
+
+    if (!opciones.simd.empty() && opciones.simd != "comparar") {
+        NivelSimd nivel;
+        leerNivelSimd(opciones.simd, nivel);
+        elegirNivelSimd(nivel);
+    }
+    printf("relajacion: %s (disponible: %s)\n", nombreNivelSimd(nivelSimdActual()),
+           nombreNivelSimd(nivelSimdDisponible()));
+    if (opciones.suite) return ejecutarSuite(opciones);
+
+    Cuadricula cuadricula;
+    if (!opciones.mapa.empty() && !cargarMapa(opciones.mapa, opciones.espaciado, cuadricula)) {
+        fprintf(stderr, "no se pudo leer el mapa %s\n", opciones.mapa.c_str());
+        return 1;
+    }
+    vector<ConsultaEscenario> escenarios;
+    if (!opciones.escenarios.empty() && !cargarEscenarios(opciones.escenarios, escenarios)) {
+        fprintf(stderr, "no se pudo leer el archivo de escenarios %s\n", opciones.escenarios.c_str());
+        return 1;
+    }
+
+    ArchivoMapa archivo;
+    if (!opciones.binario.empty()) {
+        auto t0 = chrono::steady_clock::now();
+        if (!archivo.abrir(opciones.binario)) return 1;
+        printf("archivo %s: %.1f MB mapeados, apertura: %.3f ms\n", opciones.binario.c_str(),
+               archivo.bytes() / 1048576.0, chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+    }
+
+    if (opciones.grafo == "implicito") {
+        // Sin mapa se genera directamente el grafo, sin pasar por la Cuadricula
+        auto t0 = chrono::steady_clock::now();
+        GrafoCuadricula grafo = archivo.abierto()
+            ? GrafoCuadricula(archivo.copiarObstaculos(), archivo.obtenerEspaciado())
+            : opciones.mapa.empty() && opciones.generador == "aleatorio"
+            ? generarGrafoCuadriculaAleatorio(opciones.columnas, opciones.filas, opciones.espaciado,
+                                              opciones.densidad, opciones.semilla)
+            : GrafoCuadricula(opciones.mapa.empty()
+                  ? generarCuadricula(opciones.generador, opciones.columnas, opciones.filas, opciones.espaciado,
+                                      opciones.densidad, opciones.habitacion, opciones.semilla)
+                  : cuadricula);
+        double msConstruccion = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        vector<pair<int, int>> consultas =
+            elegirConsultas(grafo, grafo.obtenerColumnas(), grafo.obtenerFilas(), escenarios, opciones);
+        if (consultas.empty()) {
+            fprintf(stderr, "no hay consultas: el mapa no tiene celdas libres o el .scen es de otro mapa\n");
+            return 1;
+        }
+        printf("mapa: %dx%d (%d nodos), grafo implicito: %.1f MB, construccion: %.2f ms\n",
+               grafo.obtenerColumnas(), grafo.obtenerFilas(), grafo.totalNodos(),
+               grafo.bytes() / 1048576.0, msConstruccion);
+
+        // JPS+ necesita la tabla de saltos; se construye una vez para todas las consultas
+        unique_ptr<TablaSaltos> tabla;
+        for (auto& variante : opciones.variantes) {
+            if (variante.busqueda.algoritmo != Algoritmo::JPSMas) continue;
+            if (!tabla) {
+                t0 = chrono::steady_clock::now();
+                tabla.reset(new TablaSaltos(grafo));
+                printf("tabla de saltos: %.1f MB, construccion: %.2f ms\n", tabla->bytes() / 1048576.0,
+                       chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+            }
+            variante.busqueda.tablaSaltos = tabla.get();
+        }
+        // Igual con la jerarquia de HPA*
+        unique_ptr<MapaJerarquico> jerarquia;
+        for (auto& variante : opciones.variantes) {
+            if (variante.busqueda.algoritmo != Algoritmo::Jerarquico) continue;
+            if (!jerarquia) {
+                t0 = chrono::steady_clock::now();
+                jerarquia.reset(new MapaJerarquico(grafo, opciones.tamanoCluster));
+                printf("jerarquia: clusters de %d, %d clusters, %d entradas, %.1f MB, construccion: %.2f ms\n",
+                       jerarquia->obtenerTamanoCluster(), jerarquia->totalClusters(), jerarquia->totalEntradas(),
+                       jerarquia->bytes() / 1048576.0,
+                       chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count());
+            }
+            variante.busqueda.jerarquia = jerarquia.get();
+        }
+        unique_ptr<JerarquiaContraccion> contraccion = prepararContraccion(grafo, opciones.variantes, archivo);
+        if (!opciones.guardar.empty() && !guardarMapa(opciones.guardar, grafo, nullptr, contraccion.get())) return 1;
+        int estado = ejecutarVariantes(grafo, consultas, opciones.variantes, opciones.espacioNuevo,
+                                       opciones.escalado, opciones.matriz, opciones.campo, opciones.delta,
+                                       opciones.agentes, opciones.asincrono, opciones.pasos, opciones.estadisticas);
+        if (jerarquia) medirActualizacionJerarquia(grafo, *jerarquia, opciones.semilla);
+        if (opciones.replanificacion > 0) medirReplanificacion(grafo, consultas, opciones.replanificacion);
+        if (opciones.cache > 0) medirCache(grafo, consultas, opciones.variantes[0], opciones.cache, opciones.semilla);
+        if (opciones.simd == "comparar") medirSimd(grafo, consultas, opciones.variantes[0]);
+        return estado;
+    }
+
+    for (const Variante& variante : opciones.variantes) {
+        if (requiereCuadricula(variante.busqueda.algoritmo)) {
+            fprintf(stderr, "%s solo funciona con --grafo implicito\n", variante.nombre.c_str());
+            return 1;
+        }
+    }
+
+    if (archivo.abierto()) {
+        // El CSR se usa directamente desde las paginas del archivo
+        if (!archivo.tieneGrafo()) {
+            fprintf(stderr, "%s no tiene grafo CSR (se guardo con --grafo implicito)\n", opciones.binario.c_str());
+            return 1;
+        }
+        GrafoMapeado grafo = archivo.grafo();
+        vector<pair<int, int>> consultas =
+            elegirConsultas(grafo, archivo.obtenerColumnas(), archivo.obtenerFilas(), escenarios, opciones);
+        if (consultas.empty()) {
+            fprintf(stderr, "no hay consultas: el mapa no tiene celdas libres o el .scen es de otro mapa\n");
+            return 1;
+        }
+        printf("mapa: %dx%d (%d nodos, %d aristas), grafo CSR mapeado\n", archivo.obtenerColumnas(),
+               archivo.obtenerFilas(), grafo.totalNodos(), grafo.totalAristas());
+        unique_ptr<JerarquiaContraccion> contraccion = prepararContraccion(grafo, opciones.variantes, archivo);
+        return ejecutarVariantes(grafo, consultas, opciones.variantes, opciones.espacioNuevo, opciones.escalado,
+                                 opciones.matriz, opciones.campo, opciones.delta, opciones.agentes,
+                                 opciones.asincrono, opciones.pasos, opciones.estadisticas);
+    }
+
+    if (opciones.mapa.empty()) {
+        cuadricula = generarCuadricula(opciones.generador, opciones.columnas, opciones.filas, opciones.espaciado,
+                                       opciones.densidad, opciones.habitacion, opciones.semilla);
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    Grafo grafo = construirGrafo(cuadricula);
+    double msConstruccion = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    vector<pair<int, int>> consultas =
+        elegirConsultas(cuadricula, cuadricula.columnas, cuadricula.filas, escenarios, opciones);
+    if (consultas.empty()) {
+        fprintf(stderr, "no hay consultas: el mapa no tiene celdas libres o el .scen es de otro mapa\n");
+        return 1;
+    }
+    size_t bytesGrafo = grafo.inicios.size() * sizeof(int) + grafo.destinos.size() * sizeof(int) +
+                        grafo.costos.size() * sizeof(float);
+    printf("mapa: %dx%d (%d nodos, %d aristas), grafo CSR: %.1f MB, construccion: %.2f ms\n",
+           cuadricula.columnas, cuadricula.filas, cuadricula.totalNodos(), grafo.totalAristas(),
+           bytesGrafo / 1048576.0, msConstruccion);
+    VistaGrafo vista{grafo, cuadricula};
+    unique_ptr<JerarquiaContraccion> contraccion = prepararContraccion(vista, opciones.variantes, archivo);
+    if (!opciones.guardar.empty() && !guardarMapa(opciones.guardar, GrafoCuadricula(cuadricula), &grafo,
+                                                  contraccion.get())) {
+        return 1;
+    }
+    return ejecutarVariantes(vista, consultas, opciones.variantes, opciones.espacioNuevo, opciones.escalado,
+                             opciones.matriz, opciones.campo, opciones.delta, opciones.agentes,
+                             opciones.asincrono, opciones.pasos, opciones.estadisticas);
+}
@@ -1,9 +1,29 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
 #include <vector>
 #include <cmath>
-#include <queue>
 #include <iostream>
-#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "archivo_mapa.h"
+#include "busqueda.h"
+#include "busqueda_asincrona.h"
+#include "busqueda_por_pasos.h"
+#include "cache_rutas.h"
+#include "capas_cuadricula.h"
+#include "campo_flujo.h"
+#include "contraccion.h"
+#include "cuadricula.h"
+#include "dstar_lite.h"
+#include "grafo_cuadricula.h"
+#include "panel_estadisticas.h"
 
 using namespace std;
 using namespace sf;
@@ -11,122 +31,162 @@ using namespace sf;
 const int ANCHO = 800;
 const int ALTO = 600;
 const int ESPACIADO_NODOS = 20;
+const int AGENTES_FLUJO = 200;
+const int NODOS_POR_CUADRO = 20;
 
-struct Nodo {
-    Vector2f posicion;
-    bool es_obstaculo = false;
-    int indice;
-};
-
-struct Arista {
-    int destino;
-    float costo;
-    Arista(int d, float c) : destino(d), costo(c) {}
-};
-
-struct Estado {
-    int nodo;
-    float costo;
-    Estado(int n, float c) : nodo(n), costo(c) {}
-    bool operator<(const Estado& otro) const {
-        return costo > otro.costo;
-    }
-};
+const string TITULO = "Visualizacion de Dijkstra";
 
-int obtenerIndice(int x, int y, int columnas) {
-    return y * columnas + x;
+// Centro de la celda en pixeles
+Vector2f posicionDe(int indice, int columnas) {
+    return Vector2f((indice % columnas) * ESPACIADO_NODOS + ESPACIADO_NODOS / 2.f,
+                    (indice / columnas) * ESPACIADO_NODOS + ESPACIADO_NODOS / 2.f);
 }
 
-int main() {
-    RenderWindow ventana(VideoMode(ANCHO, ALTO), "Visualizacion de Dijkstra");
+// main [mapa.djk | columnas filas]: sin argumentos se usa una cuadricula
+// vacia del tamano de la ventana y con columnas y filas una aleatoria (20%
+// de obstaculos); G guarda el mapa actual en mapa.djk. Los costos usan el
+// espaciado del archivo y el dibujo siempre ESPACIADO_NODOS.
+int main(int argc, char** argv) {
+    RenderWindow ventana(VideoMode(ANCHO, ALTO), TITULO);
 
     int columnas = ANCHO / ESPACIADO_NODOS;
     int filas = ALTO / ESPACIADO_NODOS;
-    int totalNodos = columnas * filas;  
-
-    vector<Nodo> nodos(totalNodos);
-    for (int y = 0; y < filas; y++) {
-        for (int x = 0; x < columnas; x++) {
-            int idx = obtenerIndice(x, y, columnas);
-            nodos[idx].posicion = Vector2f(x * ESPACIADO_NODOS + ESPACIADO_NODOS / 2.f, y * ESPACIADO_NODOS + ESPACIADO_NODOS / 2.f);
-            nodos[idx].indice = idx;
-        }
+    ArchivoMapa archivo;
+    bool aleatorio = argc > 2;
+    if (aleatorio) {
+        columnas = atoi(argv[1]);
+        filas = atoi(argv[2]);
+        if (columnas <= 0 || filas <= 0) return 1;
+    } else if (argc > 1) {
+        if (!archivo.abrir(argv[1])) return 1;
+        columnas = archivo.obtenerColumnas();
+        filas = archivo.obtenerFilas();
     }
 
-    vector<vector<Arista>> grafo(totalNodos);
-    auto esValido = [&](int x, int y) {
-        return x >= 0 && y >= 0 && x < columnas && y < filas;
+    // El mismo mapa de bits sirve para buscar y para dibujar
+    GrafoCuadricula grafo = archivo.abierto()
+        ? GrafoCuadricula(archivo.copiarObstaculos(), archivo.obtenerEspaciado())
+        : aleatorio
+        ? generarGrafoCuadriculaAleatorio(columnas, filas, ESPACIADO_NODOS, 0.2f, 1)
+        : GrafoCuadricula(columnas, filas, ESPACIADO_NODOS);
+    CapasCuadricula capas(grafo, ESPACIADO_NODOS);
+    ContadorCuadros contador;
+
+    // Camara: rueda para acercar o alejar sobre el cursor, flechas o boton
+    // del medio para desplazar, Inicio para ver el mapa entero
+    View camara(FloatRect(0, 0, ANCHO, ALTO));
+    float zoom = 1;
+    bool arrastrando = false;
+    Vector2i ultimoPixel;
+    auto verMapaEntero = [&]() {
+        Vector2u tamano = ventana.getSize();
+        zoom = max(columnas * ESPACIADO_NODOS / (float)tamano.x, filas * ESPACIADO_NODOS / (float)tamano.y);
+        camara.setSize(tamano.x * zoom, tamano.y * zoom);
+        camara.setCenter(columnas * ESPACIADO_NODOS / 2.f, filas * ESPACIADO_NODOS / 2.f);
     };
 
-    for (int y = 0; y < filas; y++) {
-        for (int x = 0; x < columnas; x++) {
-            int desde = obtenerIndice(x, y, columnas);
-            for (int dx = -1; dx <= 1; dx++) {
-                for (int dy = -1; dy <= 1; dy++) {
-                    if (!(dx == 0 && dy == 0)) {
-                        int nx = x + dx;
-                        int ny = y + dy;
-                        if (esValido(nx, ny)) {
-                            int hacia = obtenerIndice(nx, ny, columnas);
-                            float distancia = sqrt(dx * dx + dy * dy) * ESPACIADO_NODOS;
-                            grafo[desde].push_back(Arista(hacia, distancia));
-                        }
-                    }
-                }
-            }
-        }
-    }
-
     CircleShape agente(8);
     agente.setFillColor(Color::Blue);
-    int nodoInicio = obtenerIndice(5, 5, columnas);
-    Vector2f posicionAgente = nodos[nodoInicio].posicion;
+    int nodoInicio = obtenerIndice(min(5, columnas - 1), min(5, filas - 1), columnas);
+    Vector2f posicionAgente = posicionDe(nodoInicio, columnas);
 
     vector<int> camino;
     size_t indiceCamino = 0;
-    vector<int> nodosVisitados;
-
-    auto dijkstra = [&](int inicio, int meta) -> vector<int> {
-        nodosVisitados.clear();
-        vector<float> distancias(totalNodos, 1e9f);
-        vector<int> desde(totalNodos, -1);
-        priority_queue<Estado> cola;
-
-        distancias[inicio] = 0;
-        cola.push(Estado(inicio, 0));
-
-        while (!cola.empty()) {
-            Estado actual = cola.top();
-            cola.pop();
-
-            if (actual.nodo == meta) {
-                break;
-            }
+    PanelEstadisticas panel;
+    string nombreBusqueda = nombreAlgoritmo(Algoritmo::Dijkstra);
+    auto mostrarRuta = [&](const ResultadoBusqueda& resultado) {
+        camino = resultado.camino;
+        indiceCamino = 0;
+        capas.ponerCamino(camino);
+        capas.ponerVisitados(resultado.nodosVisitados);
+        panel.mostrar(nombreBusqueda, resultado);
+    };
 
-            if (actual.costo <= distancias[actual.nodo]) {
-                nodosVisitados.push_back(actual.nodo);
-
-                for (auto& arista : grafo[actual.nodo]) {
-                    int siguiente = arista.destino;
-                    if (!nodos[siguiente].es_obstaculo) {
-                        float nuevoCosto = distancias[actual.nodo] + arista.costo;
-                        if (nuevoCosto < distancias[siguiente]) {
-                            distancias[siguiente] = nuevoCosto;
-                            desde[siguiente] = actual.nodo;
-                            cola.push(Estado(siguiente, nuevoCosto));
-                        }
-                    }
-                }
-            }
+    // D: Dijkstra, A: A* octil, W: A* ponderado (peso 1.5), J: Jump Point Search,
+    // B: A* bidireccional, H: HPA* (clusters de 8x8, se arma al elegirlo), C: Contraction Hierarchies
+    // (si cambio el mapa se reconstruye en otro hilo al buscar), I: alterna D* Lite
+    // (replanifica al alternar obstaculos), F: alterna el campo de flujo
+    // (AGENTES_FLUJO agentes van a la meta del clic derecho leyendo su celda,
+    // sin buscar rutas), P: alterna la busqueda por pasos (Dijkstra, o A* si esta elegido, avanzando
+    // NODOS_POR_CUADRO nodos por cuadro), E: muestra u oculta los contadores
+    // de la ultima busqueda
+    // Las busquedas del clic derecho corren en otro hilo y se recogen en el
+    // bucle de cuadros; un clic nuevo reemplaza a la busqueda en curso y
+    // alternar un obstaculo la vuelve a pedir sobre el mapa nuevo. Las rutas
+    // que llegan se guardan en la cache, que se vacia al cambiar de
+    // algoritmo y pierde solo las afectadas al alternar un obstaculo
+    OpcionesBusqueda opcionesBusqueda;
+    BuscadorAsincrono buscador;
+    CacheRutas cacheRutas(grafo);
+    int consultaInicio = -1, consultaMeta = -1;
+    uint64_t consultaVersion = 0;
+    bool consultaEnCurso = false;  // pedida y sin recoger: al editar el mapa se vuelve a pedir
+    EspacioBusqueda espacioPasos;
+    BusquedaPorPasos<GrafoCuadricula> busquedaPasos(grafo, espacioPasos);
+    bool porPasos = false;
+    // La jerarquia de HPA* se construye la primera vez que se elige H y
+    // desde ahi se actualiza con cada edicion
+    unique_ptr<MapaJerarquico> jerarquia;
+    unique_ptr<JerarquiaContraccion> contraccion;
+    if (archivo.abierto() && archivo.tieneContraccion() && archivo.totalNodos() == grafo.totalNodos()) {
+        contraccion.reset(new JerarquiaContraccion(archivo.copiarContraccion()));
+        opcionesBusqueda.contraccion = contraccion.get();
+    }
+    // La jerarquia se construye en otro hilo sobre una copia de las aristas;
+    // el clic que la pidio queda en consultaInicio/consultaMeta hasta que este
+    atomic<bool> cancelarContraccion{false};
+    future<unique_ptr<JerarquiaContraccion>> construccion;
+    bool esperaContraccion = false;
+    auto descartarConstruccion = [&]() {
+        esperaContraccion = false;
+        if (!construccion.valid()) return;
+        cancelarContraccion = true;
+        construccion.get();
+        cancelarContraccion = false;
+    };
+    PlanificadorIncremental planificador(grafo);
+    bool incremental = false;
+    bool flujo = false;
+    CampoFlujo campoFlujo;
+    GrupoHilos hilos;
+    vector<Vector2f> agentesFlujo;
+    mt19937 generador(1);
+    auto nodoAgente = [&]() {
+        return obtenerIndice((int)(posicionAgente.x / ESPACIADO_NODOS), (int)(posicionAgente.y / ESPACIADO_NODOS), columnas);
+    };
+    // Ruta del agente a meta desde la cache o en el buscador
+    auto pedirRuta = [&](int meta) {
+        busquedaPasos.detener();
+        ResultadoBusqueda guardada;
+        if (cacheRutas.buscar(nodoAgente(), meta, guardada)) {
+            // Sin buscar: la que estaba en curso ya no sirve
+            buscador.cancelar();
+            consultaEnCurso = false;
+            nombreBusqueda = string(nombreAlgoritmo(opcionesBusqueda.algoritmo)) + " (cache)";
+            mostrarRuta(guardada);
+            return;
         }
-
-        vector<int> caminoReverso;
-        if (desde[meta] == -1) return {};
-        for (int actual = meta; actual != -1; actual = desde[actual]) {
-            caminoReverso.push_back(actual);
+        // El agente se detiene hasta que llegue la ruta nueva
+        consultaInicio = nodoAgente();
+        consultaMeta = meta;
+        consultaVersion = cacheRutas.obtenerVersion();
+        consultaEnCurso = true;
+        if (opcionesBusqueda.algoritmo == Algoritmo::Contraccion && !contraccion) {
+            buscador.cancelar();
+            esperaContraccion = true;
+            if (!construccion.valid()) {
+                cout << "Construyendo Contraction Hierarchies..." << endl;
+                construccion = async(launch::async, [aristas = copiarAristas(grafo), &cancelarContraccion]() {
+                    return unique_ptr<JerarquiaContraccion>(new JerarquiaContraccion(aristas, &cancelarContraccion));
+                });
+            }
+        } else {
+            buscador.solicitar(grafo, consultaInicio, consultaMeta, opcionesBusqueda);
         }
-        reverse(caminoReverso.begin(), caminoReverso.end());
-        return caminoReverso;
+        nombreBusqueda = nombreAlgoritmo(opcionesBusqueda.algoritmo);
+        camino.clear();
+        indiceCamino = 0;
+        capas.ponerCamino(camino);
     };
 
     while (ventana.isOpen()) {
@@ -135,26 +195,185 @@ int main() {
             if (evento.type == Event::Closed)
                 ventana.close();
 
+            if (evento.type == Event::Resized) {
+                camara.setSize(evento.size.width * zoom, evento.size.height * zoom);
+            } else if (evento.type == Event::MouseWheelScrolled) {
+                Vector2i pixel(evento.mouseWheelScroll.x, evento.mouseWheelScroll.y);
+                Vector2f antes = ventana.mapPixelToCoords(pixel, camara);
+                float factor = evento.mouseWheelScroll.delta > 0 ? 0.8f : 1.25f;
+                camara.zoom(factor);
+                zoom *= factor;
+                camara.move(antes - ventana.mapPixelToCoords(pixel, camara));
+            } else if (evento.type == Event::MouseButtonPressed && evento.mouseButton.button == Mouse::Middle) {
+                arrastrando = true;
+                ultimoPixel = Vector2i(evento.mouseButton.x, evento.mouseButton.y);
+            } else if (evento.type == Event::MouseButtonReleased && evento.mouseButton.button == Mouse::Middle) {
+                arrastrando = false;
+            } else if (evento.type == Event::MouseMoved && arrastrando) {
+                Vector2i pixel(evento.mouseMove.x, evento.mouseMove.y);
+                camara.move(ventana.mapPixelToCoords(ultimoPixel, camara) - ventana.mapPixelToCoords(pixel, camara));
+                ultimoPixel = pixel;
+            }
+
+            if (evento.type == Event::KeyPressed && (evento.key.code == Keyboard::Left ||
+                                                     evento.key.code == Keyboard::Right ||
+                                                     evento.key.code == Keyboard::Up ||
+                                                     evento.key.code == Keyboard::Down ||
+                                                     evento.key.code == Keyboard::Home)) {
+                Vector2f paso = camara.getSize() * 0.1f;
+                if (evento.key.code == Keyboard::Left) camara.move(-paso.x, 0);
+                else if (evento.key.code == Keyboard::Right) camara.move(paso.x, 0);
+                else if (evento.key.code == Keyboard::Up) camara.move(0, -paso.y);
+                else if (evento.key.code == Keyboard::Down) camara.move(0, paso.y);
+                else verMapaEntero();
+            } else if (evento.type == Event::KeyPressed && evento.key.code == Keyboard::E) {
+                bool visible = panel.alternar();
+                if (!panel.tieneFuente()) cout << "Estadisticas por consola: " << (visible ? "si" : "no") << endl;
+            } else if (evento.type == Event::KeyPressed && evento.key.code == Keyboard::G) {
+                if (guardarMapa("mapa.djk", grafo, nullptr, contraccion.get()))
+                    cout << "Mapa guardado en mapa.djk" << endl;
+            } else if (evento.type == Event::KeyPressed) {
+                Algoritmo algoritmoAnterior = opcionesBusqueda.algoritmo;
+                float pesoAnterior = opcionesBusqueda.peso;
+                if (evento.key.code == Keyboard::I) {
+                    incremental = !incremental;
+                    cout << "D* Lite (incremental): " << (incremental ? "si" : "no") << endl;
+                }
+                if (evento.key.code == Keyboard::P) {
+                    porPasos = !porPasos;
+                    cout << "Busqueda por pasos: " << (porPasos ? "si" : "no") << endl;
+                }
+                if (evento.key.code == Keyboard::F) {
+                    flujo = !flujo;
+                    if (flujo) {
+                        // Agentes nuevos en celdas libres al azar
+                        agentesFlujo.clear();
+                        campoFlujo.invalidar();
+                        uniform_int_distribution<int> celda(0, grafo.totalNodos() - 1);
+                        for (int intento = 0; intento < AGENTES_FLUJO * 100; intento++) {
+                            if ((int)agentesFlujo.size() == AGENTES_FLUJO) break;
+                            int nodo = celda(generador);
+                            if (!grafo.esObstaculo(nodo)) agentesFlujo.push_back(posicionDe(nodo, columnas));
+                        }
+                        cout << "Campo de flujo: " << agentesFlujo.size() << " agentes" << endl;
+                    } else {
+                        cout << "Campo de flujo: no" << endl;
+                    }
+                }
+                bool eligeAlgoritmo = true;
+                if (evento.key.code == Keyboard::D) {
+                    opcionesBusqueda.algoritmo = Algoritmo::Dijkstra;
+                } else if (evento.key.code == Keyboard::A) {
+                    opcionesBusqueda.algoritmo = Algoritmo::AEstrella;
+                    opcionesBusqueda.peso = 1;
+                } else if (evento.key.code == Keyboard::W) {
+                    opcionesBusqueda.algoritmo = Algoritmo::AEstrella;
+                    opcionesBusqueda.peso = 1.5f;
+                } else if (evento.key.code == Keyboard::J) {
+                    opcionesBusqueda.algoritmo = Algoritmo::JPS;
+                } else if (evento.key.code == Keyboard::B) {
+                    opcionesBusqueda.algoritmo = Algoritmo::AEstrellaBidireccional;
+                } else if (evento.key.code == Keyboard::H) {
+                    opcionesBusqueda.algoritmo = Algoritmo::Jerarquico;
+                    if (!jerarquia) {
+                        jerarquia.reset(new MapaJerarquico(grafo, 8));
+                        opcionesBusqueda.jerarquia = jerarquia.get();
+                    }
+                } else if (evento.key.code == Keyboard::C) {
+                    opcionesBusqueda.algoritmo = Algoritmo::Contraccion;
+                } else {
+                    eligeAlgoritmo = false;
+                }
+                if (opcionesBusqueda.algoritmo != algoritmoAnterior || opcionesBusqueda.peso != pesoAnterior)
+                    cacheRutas.vaciar();
+                if (eligeAlgoritmo)
+                    cout << "Algoritmo: " << nombreAlgoritmo(opcionesBusqueda.algoritmo)
+                         << " (peso " << opcionesBusqueda.peso << ")" << endl;
+            }
+
             if (evento.type == Event::MouseButtonPressed) {
-                int mx = evento.mouseButton.x;
-                int my = evento.mouseButton.y;
-                int gx = mx / ESPACIADO_NODOS;
-                int gy = my / ESPACIADO_NODOS;
-                if (esValido(gx, gy)) {
+                Vector2f punto = ventana.mapPixelToCoords(Vector2i(evento.mouseButton.x, evento.mouseButton.y), camara);
+                int gx = (int)floor(punto.x / ESPACIADO_NODOS);
+                int gy = (int)floor(punto.y / ESPACIADO_NODOS);
+                if (grafo.esValido(gx, gy)) {
                     int nodoClickeado = obtenerIndice(gx, gy, columnas);
+                    if (evento.mouseButton.button == Mouse::Right) esperaContraccion = consultaEnCurso = false;
                     if (evento.mouseButton.button == Mouse::Left) {
-                        nodos[nodoClickeado].es_obstaculo = !nodos[nodoClickeado].es_obstaculo;
-                    } else if (evento.mouseButton.button == Mouse::Right) {
-                        int nodoAgenteActual = obtenerIndice((int)(posicionAgente.x / ESPACIADO_NODOS), (int)(posicionAgente.y / ESPACIADO_NODOS), columnas);
-                        camino = dijkstra(nodoAgenteActual, nodoClickeado);
+                        // El mapa no puede cambiar con una busqueda en curso; se vuelve a pedir al final
+                        bool repetirConsulta = consultaEnCurso;
+                        buscador.cancelar();
+                        busquedaPasos.detener();
+                        grafo.alternarObstaculo(nodoClickeado);
+                        cacheRutas.notificarCambio(nodoClickeado, grafo.esObstaculo(nodoClickeado));
+                        capas.actualizarCelda(nodoClickeado);
+                        if (jerarquia) jerarquia->actualizarCelda(nodoClickeado);
+                        descartarConstruccion();
+                        contraccion.reset();
+                        opcionesBusqueda.contraccion = nullptr;
+                        // El planificador se entera siempre para no quedar desactualizado
+                        planificador.notificarCambio(nodoClickeado);
+                        if (flujo && campoFlujo.valido())
+                            campoFlujo.calcular(grafo, campoFlujo.obtenerMeta(), &hilos);
+                        if (incremental && planificador.activo()) {
+                            planificador.moverInicio(nodoAgente());
+                            nombreBusqueda = "d* lite";
+                            mostrarRuta(planificador.planificar());
+                        }
+                        if (repetirConsulta) pedirRuta(consultaMeta);
+                    } else if (evento.mouseButton.button == Mouse::Right && flujo) {
+                        campoFlujo.calcular(grafo, nodoClickeado, &hilos);
+                    } else if (evento.mouseButton.button == Mouse::Right && incremental) {
+                        buscador.cancelar();
+                        busquedaPasos.detener();
+                        nombreBusqueda = "d* lite";
+                        planificador.iniciar(nodoAgente(), nodoClickeado);
+                        mostrarRuta(planificador.planificar());
+                    } else if (evento.mouseButton.button == Mouse::Right && porPasos) {
+                        buscador.cancelar();
+                        bool aEstrella = opcionesBusqueda.algoritmo == Algoritmo::AEstrella;
+                        busquedaPasos.iniciar(nodoAgente(), nodoClickeado, aEstrella ? opcionesBusqueda.peso : 0,
+                                              opcionesBusqueda.heuristica);
+                        nombreBusqueda = string(aEstrella ? "aestrella" : "dijkstra") + " por pasos";
+                        camino.clear();
                         indiceCamino = 0;
+                        capas.ponerCamino(camino);
+                        capas.ponerVisitados(camino);
+                    } else if (evento.mouseButton.button == Mouse::Right) {
+                        pedirRuta(nodoClickeado);
                     }
                 }
             }
         }
 
+        if (busquedaPasos.enCurso()) {
+            bool terminada = busquedaPasos.avanzar(NODOS_POR_CUADRO);
+            const ResultadoBusqueda& parcial = busquedaPasos.obtenerResultado();
+            capas.extenderVisitados(parcial.nodosVisitados);
+            if (terminada) {
+                camino = parcial.camino;
+                capas.ponerCamino(camino);
+                panel.mostrar(nombreBusqueda, parcial);
+            }
+        }
+
+        if (construccion.valid() && construccion.wait_for(chrono::seconds(0)) == future_status::ready) {
+            contraccion = construccion.get();
+            opcionesBusqueda.contraccion = contraccion.get();
+            cout << "Contraction Hierarchies: " << contraccion->totalAtajos() << " atajos" << endl;
+            if (esperaContraccion && opcionesBusqueda.algoritmo == Algoritmo::Contraccion)
+                buscador.solicitar(grafo, consultaInicio, consultaMeta, opcionesBusqueda);
+            esperaContraccion = false;
+        }
+
+        ResultadoBusqueda resultado;
+        if (buscador.recoger(resultado)) {
+            cacheRutas.guardar(consultaInicio, consultaMeta, resultado, consultaVersion);
+            consultaEnCurso = false;
+            mostrarRuta(resultado);
+        }
+
         if (indiceCamino < camino.size()) {
-            Vector2f destino = nodos[camino[indiceCamino]].posicion;
+            Vector2f destino = posicionDe(camino[indiceCamino], columnas);
             Vector2f direccion = destino - posicionAgente;
             float longitud = sqrt(direccion.x * direccion.x + direccion.y * direccion.y);
             if (longitud > 1.0f) {
@@ -166,42 +385,45 @@ int main() {
             }
         }
 
-        ventana.clear();
-
-        for (auto& nodo : nodos) {
-            RectangleShape rectangulo(Vector2f(ESPACIADO_NODOS - 1, ESPACIADO_NODOS - 1));
-            rectangulo.setOrigin(ESPACIADO_NODOS / 2.f, ESPACIADO_NODOS / 2.f);
-            rectangulo.setPosition(nodo.posicion);
-
-            if (nodo.es_obstaculo)
-                rectangulo.setFillColor(Color::Red);
-            else
-                rectangulo.setFillColor(Color(70, 70, 70));
-
-            ventana.draw(rectangulo);
-        }
-
-        for (int idx : nodosVisitados) {
-            RectangleShape rectangulo(Vector2f(ESPACIADO_NODOS - 1, ESPACIADO_NODOS - 1));
-            rectangulo.setOrigin(ESPACIADO_NODOS / 2.f, ESPACIADO_NODOS / 2.f);
-            rectangulo.setPosition(nodos[idx].posicion);
-            rectangulo.setFillColor(Color(255, 140, 0, 100));
-            ventana.draw(rectangulo);
+        // Cada agente va al centro de la celda que indica la suya
+        if (flujo && campoFlujo.valido()) {
+            for (Vector2f& posicion : agentesFlujo) {
+                int nodo = obtenerIndice((int)(posicion.x / ESPACIADO_NODOS), (int)(posicion.y / ESPACIADO_NODOS), columnas);
+                int siguiente = campoFlujo.siguiente(nodo);
+                if (siguiente == -1 && nodo != campoFlujo.obtenerMeta()) continue;
+                Vector2f direccion = posicionDe(siguiente == -1 ? nodo : siguiente, columnas) - posicion;
+                float longitud = sqrt(direccion.x * direccion.x + direccion.y * direccion.y);
+                if (longitud > 2.5f)
+                    posicion += direccion / longitud * 2.5f;
+                else
+                    posicion += direccion;
+            }
         }
 
-        for (int i = 0; i + 1 < camino.size(); i++) {
-            Vertex linea[] = {
-                Vertex(nodos[camino[i]].posicion, Color::Green),
-                Vertex(nodos[camino[i + 1]].posicion, Color::Green)
-            };
-            ventana.draw(linea, 2, Lines);
-        }
+        ventana.clear();
+        ventana.setView(camara);
+        capas.ponerAgentes(flujo ? agentesFlujo : vector<Vector2f>(), 4, Color::Cyan);
+        capas.dibujar(ventana);
 
         agente.setPosition(posicionAgente - Vector2f(agente.getRadius(), agente.getRadius()));
         ventana.draw(agente);
+        panel.dibujar(ventana);
 
         ventana.display();
+
+        if (contador.registrar()) {
+            char medicion[160];
+            char detalle[16] = "celdas";
+            if (capas.nivelDetalle() >= 0) snprintf(detalle, sizeof(detalle), "nivel %d", capas.nivelDetalle());
+            const CacheRutas::Estadisticas& cache = cacheRutas.obtenerEstadisticas();
+            snprintf(medicion, sizeof(medicion),
+                     " - %.0f fps, %.2f ms por cuadro (max %.2f ms), %s, cache %.0f%% de %lld",
+                     contador.cuadrosPorSegundo(), contador.msPorCuadro(), contador.msMaximo(), detalle,
+                     100 * cache.tasaAciertos(), cache.consultas);
+            ventana.setTitle(TITULO + medicion);
+        }
     }
 
+    descartarConstruccion();
     return 0;
 }
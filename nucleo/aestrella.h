@@ -0,0 +1,16 @@
+#pragma once
+
+#include "dijkstra.h"
+#include "heuristica.h"
+
+template <class G>
+ResultadoBusqueda aEstrella(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                            TipoHeuristica tipo, float peso = 1) {
+    return busquedaMejorPrimero(grafo, espacio, inicio, meta, crearHeuristica(grafo, tipo, peso));
+}
+
+template <class G>
+ResultadoBusqueda aEstrella(const G& grafo, int inicio, int meta, TipoHeuristica tipo, float peso = 1) {
+    EspacioBusqueda espacio;
+    return aEstrella(grafo, espacio, inicio, meta, tipo, peso);
+}
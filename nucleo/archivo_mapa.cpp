@@ -0,0 +1,314 @@
+#include "archivo_mapa.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char MAGIA[8] = {'D', 'I', 'J', 'K', 'M', 'A', 'P', 'A'};
+const uint32_t ORDEN = 0x01020304;
+const uint64_t ALINEACION = 64;
+
+uint64_t alinear(uint64_t valor) {
+    return (valor + ALINEACION - 1) / ALINEACION * ALINEACION;
+}
+
+uint32_t tamanoEsperado(uint32_t tipo) {
+    if (tipo == (uint32_t)TipoSeccion::Obstaculos) return sizeof(uint64_t);
+    if (tipo == (uint32_t)TipoSeccion::Costos || tipo == (uint32_t)TipoSeccion::ContraccionArribaCostos ||
+        tipo == (uint32_t)TipoSeccion::ContraccionAbajoCostos) {
+        return sizeof(float);
+    }
+    return sizeof(int);
+}
+
+struct SeccionPendiente {
+    TipoSeccion tipo;
+    const void* datos;
+    uint64_t elementos;
+};
+
+template <class T>
+void agregarSeccion(vector<SeccionPendiente>& secciones, TipoSeccion tipo, const vector<T>& datos) {
+    secciones.push_back({tipo, datos.data(), datos.size()});
+}
+
+bool escribirRelleno(FILE* archivo, uint64_t bytes) {
+    static const char ceros[ALINEACION] = {};
+    return bytes == 0 || fwrite(ceros, 1, (size_t)bytes, archivo) == bytes;
+}
+
+}  // namespace
+
+ArchivoMapa::~ArchivoMapa() {
+    cerrar();
+}
+
+void ArchivoMapa::cerrar() {
+    if (!datos) return;
+#ifdef _WIN32
+    UnmapViewOfFile(datos);
+#else
+    munmap(const_cast<unsigned char*>(datos), tamano);
+#endif
+    datos = nullptr;
+    tamano = 0;
+}
+
+bool ArchivoMapa::abrir(const string& ruta) {
+    cerrar();
+    // Los manejadores se cierran enseguida; la vista mapeada los mantiene vivos
+#ifdef _WIN32
+    HANDLE archivo = CreateFileA(ruta.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (archivo == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "no se pudo abrir %s\n", ruta.c_str());
+        return false;
+    }
+    LARGE_INTEGER tamanoArchivo;
+    HANDLE mapeo = nullptr;
+    if (GetFileSizeEx(archivo, &tamanoArchivo) && tamanoArchivo.QuadPart > 0) {
+        mapeo = CreateFileMappingA(archivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (mapeo) {
+        datos = static_cast<const unsigned char*>(MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapeo);
+    }
+    CloseHandle(archivo);
+    if (!datos) {
+        fprintf(stderr, "no se pudo mapear %s\n", ruta.c_str());
+        return false;
+    }
+    tamano = (size_t)tamanoArchivo.QuadPart;
+#else
+    int archivo = open(ruta.c_str(), O_RDONLY);
+    if (archivo < 0) {
+        fprintf(stderr, "no se pudo abrir %s\n", ruta.c_str());
+        return false;
+    }
+    struct stat estado;
+    void* mapeo = MAP_FAILED;
+    if (fstat(archivo, &estado) == 0 && estado.st_size > 0) {
+        mapeo = mmap(nullptr, (size_t)estado.st_size, PROT_READ, MAP_SHARED, archivo, 0);
+    }
+    close(archivo);
+    if (mapeo == MAP_FAILED) {
+        fprintf(stderr, "no se pudo mapear %s\n", ruta.c_str());
+        return false;
+    }
+    datos = static_cast<const unsigned char*>(mapeo);
+    tamano = (size_t)estado.st_size;
+#endif
+
+    auto invalido = [&](const char* motivo) {
+        fprintf(stderr, "%s: %s\n", ruta.c_str(), motivo);
+        cerrar();
+        return false;
+    };
+
+    if (tamano < sizeof(CabeceraArchivoMapa) || memcmp(cabecera().magia, MAGIA, sizeof(MAGIA)) != 0) {
+        return invalido("no es un archivo de mapa");
+    }
+    if (cabecera().orden != ORDEN) return invalido("orden de bytes distinto al de esta maquina");
+    if (cabecera().version != VERSION_ARCHIVO_MAPA) return invalido("version de archivo no soportada");
+    if (cabecera().columnas <= 0 || cabecera().filas <= 0 ||
+        (int64_t)cabecera().columnas * cabecera().filas > INT32_MAX - 1) {
+        return invalido("dimensiones invalidas");
+    }
+    uint64_t finTabla = sizeof(CabeceraArchivoMapa) + (uint64_t)cabecera().totalSecciones * sizeof(EntradaSeccion);
+    if (finTabla > tamano) return invalido("tabla de secciones truncada");
+
+    const EntradaSeccion* tabla = reinterpret_cast<const EntradaSeccion*>(datos + sizeof(CabeceraArchivoMapa));
+    for (uint32_t i = 0; i < cabecera().totalSecciones; i++) {
+        const EntradaSeccion& entrada = tabla[i];
+        if (entrada.tamanoElemento != tamanoEsperado(entrada.tipo) || entrada.desplazamiento % ALINEACION != 0 ||
+            entrada.desplazamiento > tamano ||
+            entrada.elementos > (tamano - entrada.desplazamiento) / entrada.tamanoElemento) {
+            return invalido("seccion fuera del archivo");
+        }
+    }
+
+    // Solo se comprueba que los tamanos sean coherentes, no el contenido
+    uint64_t elementos = 0;
+    int nodos = totalNodos();
+    uint64_t palabras = (uint64_t)(obtenerColumnas() + 63) / 64 * obtenerFilas();
+    if (!seccion<uint64_t>(TipoSeccion::Obstaculos, elementos) || elementos != palabras) {
+        return invalido("falta el mapa de obstaculos");
+    }
+    // Aristas del CSR o -1 si los arreglos no coinciden
+    auto aristasCSR = [&](TipoSeccion tipoInicios, TipoSeccion tipoDestinos, TipoSeccion tipoCostos) -> int64_t {
+        uint64_t totalInicios = 0, totalDestinos = 0, totalCostos = 0;
+        const int* inicios = seccion<int>(tipoInicios, totalInicios);
+        seccion<int>(tipoDestinos, totalDestinos);
+        seccion<float>(tipoCostos, totalCostos);
+        if (!inicios || totalInicios != (uint64_t)nodos + 1 || inicios[0] != 0 || inicios[nodos] < 0) return -1;
+        if (totalDestinos != (uint64_t)inicios[nodos] || totalCostos != totalDestinos) return -1;
+        return inicios[nodos];
+    };
+    if (buscarSeccion(TipoSeccion::Inicios) &&
+        aristasCSR(TipoSeccion::Inicios, TipoSeccion::Destinos, TipoSeccion::Costos) < 0) {
+        return invalido("grafo CSR incompleto");
+    }
+    if (buscarSeccion(TipoSeccion::ContraccionRango)) {
+        uint64_t rangos = 0, mediosArriba = 0, mediosAbajo = 0;
+        seccion<int>(TipoSeccion::ContraccionRango, rangos);
+        seccion<int>(TipoSeccion::ContraccionArribaMedios, mediosArriba);
+        seccion<int>(TipoSeccion::ContraccionAbajoMedios, mediosAbajo);
+        int64_t arriba = aristasCSR(TipoSeccion::ContraccionArribaInicios, TipoSeccion::ContraccionArribaDestinos,
+                                    TipoSeccion::ContraccionArribaCostos);
+        int64_t abajo = aristasCSR(TipoSeccion::ContraccionAbajoInicios, TipoSeccion::ContraccionAbajoDestinos,
+                                   TipoSeccion::ContraccionAbajoCostos);
+        if (rangos != (uint64_t)nodos || arriba < 0 || abajo < 0 || mediosArriba != (uint64_t)arriba ||
+            mediosAbajo != (uint64_t)abajo) {
+            return invalido("jerarquia de contraccion incompleta");
+        }
+    }
+    return true;
+}
+
+const EntradaSeccion* ArchivoMapa::buscarSeccion(TipoSeccion tipo) const {
+    const EntradaSeccion* tabla = reinterpret_cast<const EntradaSeccion*>(datos + sizeof(CabeceraArchivoMapa));
+    for (uint32_t i = 0; i < cabecera().totalSecciones; i++) {
+        if (tabla[i].tipo == (uint32_t)tipo) return &tabla[i];
+    }
+    return nullptr;
+}
+
+template <class T>
+const T* ArchivoMapa::seccion(TipoSeccion tipo, uint64_t& elementos) const {
+    const EntradaSeccion* entrada = buscarSeccion(tipo);
+    elementos = entrada ? entrada->elementos : 0;
+    return entrada ? reinterpret_cast<const T*>(datos + entrada->desplazamiento) : nullptr;
+}
+
+const uint64_t* ArchivoMapa::obstaculos() const {
+    uint64_t elementos;
+    return seccion<uint64_t>(TipoSeccion::Obstaculos, elementos);
+}
+
+bool ArchivoMapa::tieneGrafo() const {
+    return buscarSeccion(TipoSeccion::Inicios) != nullptr;
+}
+
+GrafoMapeado ArchivoMapa::grafo() const {
+    uint64_t elementos;
+    GrafoMapeado grafo;
+    grafo.inicios = seccion<int>(TipoSeccion::Inicios, elementos);
+    grafo.destinos = seccion<int>(TipoSeccion::Destinos, elementos);
+    grafo.costos = seccion<float>(TipoSeccion::Costos, elementos);
+    grafo.obstaculos = obstaculos();
+    grafo.nodos = totalNodos();
+    grafo.columnas = obtenerColumnas();
+    grafo.palabrasPorFila = (obtenerColumnas() + 63) / 64;
+    grafo.espaciado = obtenerEspaciado();
+    return grafo;
+}
+
+bool ArchivoMapa::tieneContraccion() const {
+    return buscarSeccion(TipoSeccion::ContraccionRango) != nullptr;
+}
+
+JerarquiaContraccion ArchivoMapa::copiarContraccion() const {
+    auto enteros = [&](TipoSeccion tipo) {
+        uint64_t elementos;
+        const int* datos = seccion<int>(tipo, elementos);
+        return vector<int>(datos, datos + elementos);
+    };
+    auto reales = [&](TipoSeccion tipo) {
+        uint64_t elementos;
+        const float* datos = seccion<float>(tipo, elementos);
+        return vector<float>(datos, datos + elementos);
+    };
+    Grafo arriba, abajo;
+    arriba.inicios = enteros(TipoSeccion::ContraccionArribaInicios);
+    arriba.destinos = enteros(TipoSeccion::ContraccionArribaDestinos);
+    arriba.costos = reales(TipoSeccion::ContraccionArribaCostos);
+    abajo.inicios = enteros(TipoSeccion::ContraccionAbajoInicios);
+    abajo.destinos = enteros(TipoSeccion::ContraccionAbajoDestinos);
+    abajo.costos = reales(TipoSeccion::ContraccionAbajoCostos);
+    return JerarquiaContraccion(enteros(TipoSeccion::ContraccionRango), move(arriba), move(abajo),
+                                enteros(TipoSeccion::ContraccionArribaMedios),
+                                enteros(TipoSeccion::ContraccionAbajoMedios));
+}
+
+bool guardarMapa(const string& ruta, const GrafoCuadricula& grafo, const Grafo* csr,
+                 const JerarquiaContraccion* contraccion) {
+    const MapaBits& obstaculos = grafo.obtenerObstaculos();
+    vector<SeccionPendiente> secciones;
+    secciones.push_back({TipoSeccion::Obstaculos, obstaculos.datos(), (uint64_t)obstaculos.totalPalabras()});
+    if (csr) {
+        agregarSeccion(secciones, TipoSeccion::Inicios, csr->inicios);
+        agregarSeccion(secciones, TipoSeccion::Destinos, csr->destinos);
+        agregarSeccion(secciones, TipoSeccion::Costos, csr->costos);
+    }
+    if (contraccion) {
+        agregarSeccion(secciones, TipoSeccion::ContraccionRango, contraccion->obtenerRango());
+        agregarSeccion(secciones, TipoSeccion::ContraccionArribaInicios, contraccion->obtenerArriba().inicios);
+        agregarSeccion(secciones, TipoSeccion::ContraccionArribaDestinos, contraccion->obtenerArriba().destinos);
+        agregarSeccion(secciones, TipoSeccion::ContraccionArribaCostos, contraccion->obtenerArriba().costos);
+        agregarSeccion(secciones, TipoSeccion::ContraccionArribaMedios, contraccion->obtenerMediosArriba());
+        agregarSeccion(secciones, TipoSeccion::ContraccionAbajoInicios, contraccion->obtenerAbajo().inicios);
+        agregarSeccion(secciones, TipoSeccion::ContraccionAbajoDestinos, contraccion->obtenerAbajo().destinos);
+        agregarSeccion(secciones, TipoSeccion::ContraccionAbajoCostos, contraccion->obtenerAbajo().costos);
+        agregarSeccion(secciones, TipoSeccion::ContraccionAbajoMedios, contraccion->obtenerMediosAbajo());
+    }
+
+    CabeceraArchivoMapa cabecera = {};
+    memcpy(cabecera.magia, MAGIA, sizeof(MAGIA));
+    cabecera.version = VERSION_ARCHIVO_MAPA;
+    cabecera.orden = ORDEN;
+    cabecera.columnas = grafo.obtenerColumnas();
+    cabecera.filas = grafo.obtenerFilas();
+    cabecera.espaciado = grafo.obtenerEspaciado();
+    cabecera.totalSecciones = (uint32_t)secciones.size();
+
+    vector<EntradaSeccion> tabla;
+    uint64_t desplazamiento = alinear(sizeof(cabecera) + secciones.size() * sizeof(EntradaSeccion));
+    for (const SeccionPendiente& seccion : secciones) {
+        uint32_t tamanoElemento = tamanoEsperado((uint32_t)seccion.tipo);
+        tabla.push_back({(uint32_t)seccion.tipo, tamanoElemento, desplazamiento, seccion.elementos});
+        desplazamiento = alinear(desplazamiento + seccion.elementos * tamanoElemento);
+    }
+
+    string temporal = ruta + ".tmp";
+    FILE* archivo = fopen(temporal.c_str(), "wb");
+    if (!archivo) {
+        fprintf(stderr, "no se pudo crear %s\n", temporal.c_str());
+        return false;
+    }
+    bool correcto = fwrite(&cabecera, sizeof(cabecera), 1, archivo) == 1 &&
+                    fwrite(tabla.data(), sizeof(EntradaSeccion), tabla.size(), archivo) == tabla.size();
+    uint64_t escritos = sizeof(cabecera) + tabla.size() * sizeof(EntradaSeccion);
+    for (size_t i = 0; i < secciones.size() && correcto; i++) {
+        uint64_t bytes = secciones[i].elementos * tabla[i].tamanoElemento;
+        correcto = escribirRelleno(archivo, tabla[i].desplazamiento - escritos) &&
+                   fwrite(secciones[i].datos, 1, (size_t)bytes, archivo) == bytes;
+        escritos = tabla[i].desplazamiento + bytes;
+    }
+    correcto = fclose(archivo) == 0 && correcto;
+#ifdef _WIN32
+    // rename no reemplaza en Windows
+    if (correcto) remove(ruta.c_str());
+#endif
+    if (!correcto || rename(temporal.c_str(), ruta.c_str()) != 0) {
+        fprintf(stderr, "no se pudo escribir %s\n", ruta.c_str());
+        remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
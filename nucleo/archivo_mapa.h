@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "contraccion.h"
+#include "grafo.h"
+#include "grafo_cuadricula.h"
+#include "mapa_bits.h"
+
+// Formato binario de mapa: cabecera, tabla de secciones y cada seccion
+// alineada a 64 bytes. Las secciones son arreglos planos en el orden de bytes
+// de la maquina que escribio el archivo, asi que se pueden usar tal cual
+// desde la memoria mapeada. Solo grafo() y obstaculos() lo hacen, y solo esas
+// paginas se comparten entre procesos: GrafoCuadricula necesita su propio
+// mapa de bits para poder editarlo y JerarquiaContraccion guarda vectores,
+// asi que copiarObstaculos y copiarContraccion copian a memoria del proceso.
+// Version 2: cada fila del mapa de obstaculos empieza en una palabra nueva.
+const uint32_t VERSION_ARCHIVO_MAPA = 2;
+
+enum class TipoSeccion : uint32_t {
+    Obstaculos = 1,  // uint64_t, como MapaBits: cada fila empieza en una palabra
+    Inicios,         // CSR de construirGrafo (int, nodos + 1)
+    Destinos,
+    Costos,
+    ContraccionRango,
+    ContraccionArribaInicios,
+    ContraccionArribaDestinos,
+    ContraccionArribaCostos,
+    ContraccionArribaMedios,
+    ContraccionAbajoInicios,
+    ContraccionAbajoDestinos,
+    ContraccionAbajoCostos,
+    ContraccionAbajoMedios
+};
+
+struct CabeceraArchivoMapa {
+    char magia[8];           // "DIJKMAPA"
+    uint32_t version;
+    uint32_t orden;          // 0x01020304 escrito con el orden de bytes local
+    int32_t columnas;
+    int32_t filas;
+    float espaciado;
+    uint32_t totalSecciones;
+};
+
+struct EntradaSeccion {
+    uint32_t tipo;
+    uint32_t tamanoElemento;
+    uint64_t desplazamiento;  // desde el inicio del archivo
+    uint64_t elementos;
+};
+
+// Grafo CSR con los obstaculos, leidos directamente de un archivo mapeado.
+// Cumple la misma interfaz que VistaGrafo.
+struct GrafoMapeado {
+    const int* inicios = nullptr;
+    const int* destinos = nullptr;
+    const float* costos = nullptr;
+    const uint64_t* obstaculos = nullptr;
+    int nodos = 0;
+    int columnas = 0;
+    int palabrasPorFila = 0;
+    float espaciado = 1;
+
+    int totalNodos() const { return nodos; }
+    int totalAristas() const { return inicios[nodos]; }
+    int obtenerColumnas() const { return columnas; }
+    float obtenerEspaciado() const { return espaciado; }
+    bool esObstaculo(int nodo) const {
+        int x = nodo % columnas;
+        return (obstaculos[(size_t)(nodo / columnas) * palabrasPorFila + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    template <class F>
+    void paraCadaVecino(int nodo, F&& f) const {
+        for (int arista = inicios[nodo]; arista < inicios[nodo + 1]; arista++) {
+            int siguiente = destinos[arista];
+            if (!esObstaculo(siguiente)) f(siguiente, costos[arista]);
+        }
+    }
+};
+
+// Archivo de mapa abierto con mmap (MapViewOfFile en Windows), de solo
+// lectura. Abrir solo valida la cabecera y los tamanos de las secciones; no
+// recorre su contenido.
+class ArchivoMapa {
+public:
+    ArchivoMapa() = default;
+    ~ArchivoMapa();
+    ArchivoMapa(const ArchivoMapa&) = delete;
+    ArchivoMapa& operator=(const ArchivoMapa&) = delete;
+
+    bool abrir(const std::string& ruta);
+    void cerrar();
+    bool abierto() const { return datos != nullptr; }
+
+    int obtenerColumnas() const { return cabecera().columnas; }
+    int obtenerFilas() const { return cabecera().filas; }
+    float obtenerEspaciado() const { return cabecera().espaciado; }
+    int totalNodos() const { return cabecera().columnas * cabecera().filas; }
+    size_t bytes() const { return tamano; }
+
+    // Valido mientras el archivo siga abierto.
+    const uint64_t* obstaculos() const;
+    // Copia el mapa de bits para poder editarlo.
+    MapaBits copiarObstaculos() const { return MapaBits(obtenerColumnas(), obtenerFilas(), obstaculos()); }
+
+    bool tieneGrafo() const;
+    // Valido mientras el archivo siga abierto.
+    GrafoMapeado grafo() const;
+
+    bool tieneContraccion() const;
+    // Copia los arreglos de la jerarquia guardada: cada proceso que la use
+    // tiene la suya, del tamano que informa bytes() de la jerarquia.
+    JerarquiaContraccion copiarContraccion() const;
+
+private:
+    const CabeceraArchivoMapa& cabecera() const { return *reinterpret_cast<const CabeceraArchivoMapa*>(datos); }
+    const EntradaSeccion* buscarSeccion(TipoSeccion tipo) const;
+    template <class T>
+    const T* seccion(TipoSeccion tipo, uint64_t& elementos) const;
+
+    const unsigned char* datos = nullptr;
+    size_t tamano = 0;
+};
+
+// Escribe el mapa de bits de grafo y, si se pasan, el CSR de construirGrafo
+// y una jerarquia de contraccion construidos sobre el mismo mapa. Escribe a un
+// archivo temporal y lo renombra para no romper a quien tenga mapeado el
+// archivo anterior.
+bool guardarMapa(const std::string& ruta, const GrafoCuadricula& grafo, const Grafo* csr = nullptr,
+                 const JerarquiaContraccion* contraccion = nullptr);
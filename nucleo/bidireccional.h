@@ -0,0 +1,107 @@
+#pragma once
+
+#include "dijkstra.h"
+#include "espacio_busqueda.h"
+#include "heuristica.h"
+
+// Busqueda bidireccional: una expansion desde inicio y otra desde meta que
+// se encuentran a mitad de camino. Supone aristas simetricas (como todos los
+// grafos de cuadricula de este proyecto) y que G ofrece esObstaculo(nodo).
+//
+// Con heuristica se usan potenciales promedio, p(v) = (h(v, meta) - h(v, inicio)) / 2
+// hacia delante y -p(v) hacia atras, de modo que la suma de las claves por
+// un nodo es la longitud del camino que pasa por el. Se para cuando la suma
+// de los minimos de ambas colas alcanza la mejor ruta encontrada.
+template <class G, class H>
+ResultadoBusqueda busquedaBidireccional(const G& grafo, EspacioBusqueda& adelante, EspacioBusqueda& atras,
+                                        int inicio, int meta, const H& heuristica) {
+    ResultadoBusqueda resultado;
+    EstadisticasBusqueda& estadisticas = resultado.estadisticas;
+    if (inicio != meta && grafo.esObstaculo(meta)) return resultado;
+
+    ColaBinaria& colaAdelante = adelante.colaBinaria;
+    ColaBinaria& colaAtras = atras.colaBinaria;
+    adelante.preparar(grafo.totalNodos());
+    atras.preparar(grafo.totalNodos());
+    colaAdelante.limpiar();
+    colaAtras.limpiar();
+
+    auto potencial = [&](int nodo) {
+        return (heuristica(nodo, meta) - heuristica(nodo, inicio)) * 0.5f;
+    };
+
+    adelante.fijar(inicio, 0, -1);
+    colaAdelante.insertar(inicio, potencial(inicio));
+    atras.fijar(meta, 0, -1);
+    colaAtras.insertar(meta, -potencial(meta));
+    estadisticas.insertar(2);
+
+    // La mejor ruta sale de inicio hasta encuentroAdelante, cruza una arista
+    // y sigue por el arbol inverso desde encuentroAtras hasta meta.
+    float mejor = inicio == meta ? 0 : INFINITO;
+    int encuentroAdelante = inicio == meta ? inicio : -1;
+    int encuentroAtras = encuentroAdelante;
+
+    while (!colaAdelante.vacia() && !colaAtras.vacia()) {
+        float minimoAdelante = colaAdelante.minimo().costo;
+        float minimoAtras = colaAtras.minimo().costo;
+        if (minimoAdelante + minimoAtras >= mejor) break;
+
+        bool haciaAdelante = minimoAdelante <= minimoAtras;
+        EspacioBusqueda& propio = haciaAdelante ? adelante : atras;
+        EspacioBusqueda& opuesto = haciaAdelante ? atras : adelante;
+        ColaBinaria& cola = haciaAdelante ? colaAdelante : colaAtras;
+        float signo = haciaAdelante ? 1.f : -1.f;
+
+        Estado actual = cola.extraerMin();
+        resultado.extracciones++;
+        if (adelante.cancelada(resultado.extracciones)) return ResultadoBusqueda();
+        float distanciaActual = propio.distancia(actual.nodo);
+        if (actual.costo > distanciaActual + signo * potencial(actual.nodo)) {
+            estadisticas.descartar();
+            continue;
+        }
+        resultado.nodosVisitados.push_back(actual.nodo);
+        estadisticas.expandir();
+
+        grafo.paraCadaVecino(actual.nodo, [&](int siguiente, float costo) {
+            estadisticas.relajar();
+            float nuevoCosto = distanciaActual + costo;
+            if (nuevoCosto < propio.distancia(siguiente)) {
+                propio.fijar(siguiente, nuevoCosto, actual.nodo);
+                cola.insertar(siguiente, nuevoCosto + signo * potencial(siguiente));
+                estadisticas.insertar(colaAdelante.tamano() + colaAtras.tamano());
+            }
+            if (opuesto.alcanzado(siguiente)) {
+                float total = nuevoCosto + opuesto.distancia(siguiente);
+                if (total < mejor) {
+                    mejor = total;
+                    encuentroAdelante = haciaAdelante ? actual.nodo : siguiente;
+                    encuentroAtras = haciaAdelante ? siguiente : actual.nodo;
+                }
+            }
+        });
+    }
+
+    if (encuentroAdelante == -1) return resultado;
+    reconstruirCamino(adelante, encuentroAdelante, resultado.camino);
+    if (encuentroAtras != encuentroAdelante) {
+        for (int actual = encuentroAtras; actual != -1; actual = atras.padre(actual)) {
+            resultado.camino.push_back(actual);
+        }
+    }
+    resultado.costo = mejor;
+    return resultado;
+}
+
+template <class G>
+ResultadoBusqueda dijkstraBidireccional(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta) {
+    return busquedaBidireccional(grafo, espacio, espacio.complementario(), inicio, meta, SinHeuristica());
+}
+
+template <class G>
+ResultadoBusqueda aEstrellaBidireccional(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                                         TipoHeuristica tipo) {
+    return busquedaBidireccional(grafo, espacio, espacio.complementario(), inicio, meta,
+                                 crearHeuristica(grafo, tipo));
+}
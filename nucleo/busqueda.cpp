@@ -0,0 +1,65 @@
+#include "busqueda.h"
+
+using namespace std;
+
+bool leerAlgoritmo(const string& nombre, Algoritmo& algoritmo) {
+    if (nombre == "dijkstra") algoritmo = Algoritmo::Dijkstra;
+    else if (nombre == "aestrella") algoritmo = Algoritmo::AEstrella;
+    else if (nombre == "jps") algoritmo = Algoritmo::JPS;
+    else if (nombre == "jps+") algoritmo = Algoritmo::JPSMas;
+    else if (nombre == "dijkstra-bi") algoritmo = Algoritmo::DijkstraBidireccional;
+    else if (nombre == "aestrella-bi") algoritmo = Algoritmo::AEstrellaBidireccional;
+    else if (nombre == "hpa") algoritmo = Algoritmo::Jerarquico;
+    else if (nombre == "ch") algoritmo = Algoritmo::Contraccion;
+    else return false;
+    return true;
+}
+
+bool requiereCuadricula(Algoritmo algoritmo) {
+    return algoritmo == Algoritmo::JPS || algoritmo == Algoritmo::JPSMas || algoritmo == Algoritmo::Jerarquico;
+}
+
+bool leerHeuristica(const string& nombre, TipoHeuristica& heuristica) {
+    if (nombre == "octil") heuristica = TipoHeuristica::Octil;
+    else if (nombre == "euclidiana") heuristica = TipoHeuristica::Euclidiana;
+    else if (nombre == "manhattan") heuristica = TipoHeuristica::Manhattan;
+    else return false;
+    return true;
+}
+
+bool leerCola(const string& nombre, TipoCola& cola) {
+    if (nombre == "binaria") cola = TipoCola::Binaria;
+    else if (nombre == "cuaternaria") cola = TipoCola::Cuaternaria;
+    else if (nombre == "radix") cola = TipoCola::Radix;
+    else return false;
+    return true;
+}
+
+const char* nombreAlgoritmo(Algoritmo algoritmo) {
+    switch (algoritmo) {
+        case Algoritmo::AEstrella: return "aestrella";
+        case Algoritmo::JPS: return "jps";
+        case Algoritmo::JPSMas: return "jps+";
+        case Algoritmo::DijkstraBidireccional: return "dijkstra-bi";
+        case Algoritmo::AEstrellaBidireccional: return "aestrella-bi";
+        case Algoritmo::Jerarquico: return "hpa";
+        case Algoritmo::Contraccion: return "ch";
+        default: return "dijkstra";
+    }
+}
+
+const char* nombreHeuristica(TipoHeuristica heuristica) {
+    switch (heuristica) {
+        case TipoHeuristica::Euclidiana: return "euclidiana";
+        case TipoHeuristica::Manhattan: return "manhattan";
+        default: return "octil";
+    }
+}
+
+const char* nombreCola(TipoCola cola) {
+    switch (cola) {
+        case TipoCola::Cuaternaria: return "cuaternaria";
+        case TipoCola::Radix: return "radix";
+        default: return "binaria";
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <type_traits>
+
+#include "aestrella.h"
+#include "bidireccional.h"
+#include "colas.h"
+#include "contraccion.h"
+#include "dijkstra.h"
+#include "espacio_busqueda.h"
+#include "grafo_cuadricula.h"
+#include "heuristica.h"
+#include "jerarquico.h"
+#include "jps.h"
+
+enum class Algoritmo {
+    Dijkstra,
+    AEstrella,
+    JPS,
+    JPSMas,
+    DijkstraBidireccional,
+    AEstrellaBidireccional,
+    Jerarquico,
+    Contraccion
+};
+
+enum class TipoCola { Binaria, Cuaternaria, Radix };
+
+// Seleccion del algoritmo en tiempo de ejecucion.
+struct OpcionesBusqueda {
+    Algoritmo algoritmo = Algoritmo::Dijkstra;
+    TipoHeuristica heuristica = TipoHeuristica::Octil;
+    float peso = 1;
+    TipoCola cola = TipoCola::Binaria;                  // JPS y las bidireccionales usan la binaria
+    const TablaSaltos* tablaSaltos = nullptr;           // necesaria para JPSMas
+    const MapaJerarquico* jerarquia = nullptr;          // obligatoria para Jerarquico
+    const JerarquiaContraccion* contraccion = nullptr;  // obligatoria para Contraccion
+};
+
+// Algoritmos que solo se pueden usar sobre GrafoCuadricula.
+bool requiereCuadricula(Algoritmo algoritmo);
+
+template <class G, class H>
+ResultadoBusqueda buscarConCola(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                                const H& heuristica, TipoCola tipo) {
+    switch (tipo) {
+        case TipoCola::Cuaternaria:
+            return busquedaMejorPrimero(grafo, espacio, espacio.colaCuaternaria, inicio, meta, heuristica);
+        case TipoCola::Radix:
+            return busquedaMejorPrimero(grafo, espacio, espacio.colaRadix, inicio, meta, heuristica);
+        default:
+            return busquedaMejorPrimero(grafo, espacio, espacio.colaBinaria, inicio, meta, heuristica);
+    }
+}
+
+template <class G>
+ResultadoBusqueda despacharBusqueda(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                                   const OpcionesBusqueda& opciones) {
+    // JPS y HPA* solo existen en la cuadricula implicita, y HPA* y CH
+    // necesitan su jerarquia: lo contrario es un error de quien llama (ver
+    // requiereCuadricula) y se responde sin ruta, para no medir otro
+    // algoritmo con su nombre.
+    if constexpr (std::is_same<G, GrafoCuadricula>::value) {
+        if (opciones.algoritmo == Algoritmo::JPS) return jps(grafo, espacio, inicio, meta);
+        if (opciones.algoritmo == Algoritmo::JPSMas) return jps(grafo, espacio, inicio, meta, opciones.tablaSaltos);
+        if (opciones.algoritmo == Algoritmo::Jerarquico) {
+            assert(opciones.jerarquia && "hpa necesita opciones.jerarquia");
+            if (!opciones.jerarquia) return ResultadoBusqueda();
+            return opciones.jerarquia->buscar(espacio, inicio, meta);
+        }
+    } else if (requiereCuadricula(opciones.algoritmo)) {
+        assert(!"el algoritmo necesita la cuadricula implicita");
+        return ResultadoBusqueda();
+    }
+    switch (opciones.algoritmo) {
+        case Algoritmo::DijkstraBidireccional:
+            return dijkstraBidireccional(grafo, espacio, inicio, meta);
+        case Algoritmo::AEstrellaBidireccional:
+            return aEstrellaBidireccional(grafo, espacio, inicio, meta, opciones.heuristica);
+        case Algoritmo::Contraccion:
+            assert(opciones.contraccion && "ch necesita opciones.contraccion");
+            if (!opciones.contraccion) return ResultadoBusqueda();
+            return opciones.contraccion->buscar(espacio, inicio, meta);
+        case Algoritmo::AEstrella: {
+            // El radix exige prioridades monotonas: con peso > 1 o con Manhattan,
+            // que no es consistente con las diagonales, se usa la binaria
+            bool monotona = opciones.peso <= 1 && opciones.heuristica != TipoHeuristica::Manhattan;
+            TipoCola cola = !monotona && opciones.cola == TipoCola::Radix ? TipoCola::Binaria : opciones.cola;
+            return buscarConCola(grafo, espacio, inicio, meta,
+                                 crearHeuristica(grafo, opciones.heuristica, opciones.peso), cola);
+        }
+        default:
+            return buscarConCola(grafo, espacio, inicio, meta, SinHeuristica(), opciones.cola);
+    }
+}
+
+// Ademas de buscar, completa el tiempo y la memoria de las estadisticas.
+template <class G>
+ResultadoBusqueda buscarRuta(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                             const OpcionesBusqueda& opciones) {
+    if (!ESTADISTICAS_ACTIVAS) return despacharBusqueda(grafo, espacio, inicio, meta, opciones);
+    auto comienzo = std::chrono::steady_clock::now();
+    size_t bytesAntes = espacio.bytes();
+    ResultadoBusqueda resultado = despacharBusqueda(grafo, espacio, inicio, meta, opciones);
+    EstadisticasBusqueda& estadisticas = resultado.estadisticas;
+    estadisticas.microsegundos =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - comienzo).count();
+    estadisticas.bytes = (long long)(espacio.bytes() - bytesAntes) +
+                         (long long)((resultado.camino.capacity() + resultado.nodosVisitados.capacity()) * sizeof(int));
+    return resultado;
+}
+
+template <class G>
+ResultadoBusqueda buscarRuta(const G& grafo, int inicio, int meta, const OpcionesBusqueda& opciones) {
+    EspacioBusqueda espacio;
+    return buscarRuta(grafo, espacio, inicio, meta, opciones);
+}
+
+bool leerAlgoritmo(const std::string& nombre, Algoritmo& algoritmo);
+bool leerHeuristica(const std::string& nombre, TipoHeuristica& heuristica);
+bool leerCola(const std::string& nombre, TipoCola& cola);
+const char* nombreAlgoritmo(Algoritmo algoritmo);
+const char* nombreHeuristica(TipoHeuristica heuristica);
+const char* nombreCola(TipoCola cola);
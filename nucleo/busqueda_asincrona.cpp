@@ -0,0 +1,84 @@
+#include "busqueda_asincrona.h"
+
+#include <utility>
+
+using namespace std;
+
+BuscadorAsincrono::BuscadorAsincrono() {
+    espacio.ponerCancelacion(&cancelacion);
+    hilo = thread([this] { trabajar(); });
+}
+
+BuscadorAsincrono::~BuscadorAsincrono() {
+    {
+        lock_guard<std::mutex> candado(mutex);
+        parar = true;
+        pendiente = nullptr;
+        cancelacion = true;
+    }
+    cambio.notify_all();
+    hilo.join();
+}
+
+uint64_t BuscadorAsincrono::encolar(Tarea tarea) {
+    uint64_t numero;
+    {
+        lock_guard<std::mutex> candado(mutex);
+        numero = ++ultima;
+        pendiente = move(tarea);
+        hayTerminado = false;
+        // La que esta en curso ya no sirve
+        if (enCurso) cancelacion = true;
+    }
+    cambio.notify_all();
+    return numero;
+}
+
+void BuscadorAsincrono::cancelar() {
+    unique_lock<std::mutex> candado(mutex);
+    ++ultima;
+    pendiente = nullptr;
+    hayTerminado = false;
+    if (enCurso) cancelacion = true;
+    cambio.wait(candado, [this] { return !enCurso; });
+}
+
+bool BuscadorAsincrono::recoger(ResultadoBusqueda& resultado, uint64_t* solicitud) {
+    lock_guard<std::mutex> candado(mutex);
+    if (!hayTerminado) return false;
+    resultado = move(terminado);
+    if (solicitud) *solicitud = numeroTerminado;
+    hayTerminado = false;
+    return true;
+}
+
+bool BuscadorAsincrono::ocupado() const {
+    lock_guard<std::mutex> candado(mutex);
+    return enCurso || pendiente;
+}
+
+void BuscadorAsincrono::trabajar() {
+    unique_lock<std::mutex> candado(mutex);
+    while (true) {
+        cambio.wait(candado, [this] { return parar || pendiente; });
+        if (parar) return;
+        Tarea tarea = move(pendiente);
+        pendiente = nullptr;
+        uint64_t numero = ultima;
+        enCurso = true;
+        cancelacion = false;
+
+        candado.unlock();
+        ResultadoBusqueda resultado = tarea(espacio);
+        candado.lock();
+
+        enCurso = false;
+        // Si llego otra solicitud o se cancelo mientras tanto, se descarta
+        if (numero == ultima) {
+            terminado = move(resultado);
+            numeroTerminado = numero;
+            hayTerminado = true;
+        }
+        cambio.notify_all();
+    }
+}
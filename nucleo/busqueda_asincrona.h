@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "busqueda.h"
+#include "espacio_busqueda.h"
+
+// Busquedas en un hilo de trabajo propio, para no bloquear el hilo que
+// dibuja. Solo importa la ultima solicitud: una nueva reemplaza a la que
+// espera y cancela la que esta en curso. El resultado se recoge sin esperar
+// con recoger(), por ejemplo una vez por cuadro.
+//
+// El grafo y lo que apunten las opciones (jerarquias, tablas) no pueden
+// cambiar mientras haya una busqueda en curso: antes de modificarlos hay que
+// llamar a cancelar(), que espera a que el hilo quede libre.
+class BuscadorAsincrono {
+public:
+    BuscadorAsincrono();
+    ~BuscadorAsincrono();
+
+    BuscadorAsincrono(const BuscadorAsincrono&) = delete;
+    BuscadorAsincrono& operator=(const BuscadorAsincrono&) = delete;
+
+    // Devuelve el numero de la solicitud, que recoger() informa al terminar.
+    // El grafo tiene que vivir hasta que la busqueda termine o se cancele.
+    template <class G>
+    uint64_t solicitar(const G& grafo, int inicio, int meta, const OpcionesBusqueda& opciones) {
+        return encolar([&grafo, inicio, meta, opciones](EspacioBusqueda& espacio) {
+            return buscarRuta(grafo, espacio, inicio, meta, opciones);
+        });
+    }
+
+    // Descarta la solicitud pendiente y la que esta en curso, y espera a que
+    // el hilo de trabajo quede libre.
+    void cancelar();
+
+    // Si termino la ultima solicitud, mueve su resultado y devuelve true una
+    // sola vez. Los resultados de solicitudes reemplazadas no se entregan.
+    bool recoger(ResultadoBusqueda& resultado, uint64_t* solicitud = nullptr);
+
+    // Hay una solicitud pendiente o en curso.
+    bool ocupado() const;
+
+private:
+    using Tarea = std::function<ResultadoBusqueda(EspacioBusqueda&)>;
+
+    uint64_t encolar(Tarea tarea);
+    void trabajar();
+
+    mutable std::mutex mutex;
+    std::condition_variable cambio;
+    Tarea pendiente;
+    uint64_t ultima = 0;     // numero de la solicitud mas reciente
+    bool enCurso = false;
+    bool parar = false;
+    std::atomic<bool> cancelacion{false};
+    ResultadoBusqueda terminado;
+    uint64_t numeroTerminado = 0;
+    bool hayTerminado = false;
+    EspacioBusqueda espacio;  // solo lo usa el hilo de trabajo
+    std::thread hilo;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <type_traits>
+
+#include "dijkstra.h"
+#include "espacio_busqueda.h"
+#include "heuristica.h"
+
+// Dijkstra o A* reanudable: cada llamada a avanzar expande como mucho una
+// cantidad de nodos o durante un tiempo, y la siguiente sigue donde quedo.
+// Sirve para repartir una busqueda grande entre cuadros con un costo
+// acotado por cuadro. El grafo no puede cambiar entre llamadas (detener() y
+// volver a iniciar) y el espacio no se puede usar para otra busqueda hasta
+// que esta termine.
+template <class G>
+class BusquedaPorPasos {
+public:
+    BusquedaPorPasos(const G& grafo, EspacioBusqueda& espacio) : grafo(grafo), espacio(espacio) {}
+
+    // peso 0 es Dijkstra; peso >= 1 es A* con la heuristica tipo.
+    void iniciar(int inicio, int meta, float peso = 0, TipoHeuristica tipo = TipoHeuristica::Octil) {
+        this->meta = meta;
+        heuristica = crearHeuristica(grafo, tipo, peso);
+        // nodosVisitados crece como cualquier vector y conserva su capacidad
+        // entre busquedas; solo se reserva un minimo para las primeras
+        resultado.camino.clear();
+        resultado.nodosVisitados.clear();
+        resultado.nodosVisitados.reserve(RESERVA_VISITADOS);
+        resultado.costo = INFINITO;
+        resultado.extracciones = 0;
+        resultado.estadisticas = EstadisticasBusqueda();
+        espacio.preparar(grafo.totalNodos());
+        espacio.colaBinaria.limpiar();
+        espacio.fijar(inicio, 0, -1);
+        espacio.colaBinaria.insertar(inicio, heuristica(inicio, meta));
+        resultado.estadisticas.insertar(1);
+        activa = true;
+    }
+
+    // Expande hasta maxNodos nodos. Devuelve true si la busqueda termino.
+    bool avanzar(int maxNodos) {
+        using Reloj = std::chrono::steady_clock;
+        auto comienzo = ESTADISTICAS_ACTIVAS ? Reloj::now() : Reloj::time_point();
+        for (int expandidos = 0; activa && expandidos < maxNodos;) expandidos += paso();
+        if (ESTADISTICAS_ACTIVAS) sumarTiempo(comienzo, Reloj::now());
+        return !activa;
+    }
+
+    // Expande hasta gastar microsegundos; el reloj se mira cada pocos nodos,
+    // asi una llamada se pasa del presupuesto como mucho en ese bloque.
+    bool avanzarDurante(int microsegundos) {
+        const int BLOQUE = 32;
+        auto comienzo = std::chrono::steady_clock::now();
+        auto limite = comienzo + std::chrono::microseconds(microsegundos);
+        auto ahora = comienzo;
+        while (activa) {
+            for (int expandidos = 0; activa && expandidos < BLOQUE;) expandidos += paso();
+            ahora = std::chrono::steady_clock::now();
+            if (ahora >= limite) break;
+        }
+        if (ESTADISTICAS_ACTIVAS) sumarTiempo(comienzo, ahora);
+        return !activa;
+    }
+
+    // Abandona la busqueda sin camino.
+    void detener() { activa = false; }
+
+    bool enCurso() const { return activa; }
+    int obtenerMeta() const { return meta; }
+
+    // nodosVisitados crece con cada llamada; camino y costo quedan al terminar.
+    // estadisticas.microsegundos suma solo el tiempo dentro de avanzar.
+    const ResultadoBusqueda& obtenerResultado() const { return resultado; }
+
+private:
+    static const int RESERVA_VISITADOS = 1024;
+
+    void sumarTiempo(std::chrono::steady_clock::time_point desde, std::chrono::steady_clock::time_point hasta) {
+        resultado.estadisticas.microsegundos += std::chrono::duration<double, std::micro>(hasta - desde).count();
+    }
+
+    // Una extraccion de la cola; devuelve 1 si expandio un nodo.
+    int paso() {
+        ColaBinaria& cola = espacio.colaBinaria;
+        EstadisticasBusqueda& estadisticas = resultado.estadisticas;
+        if (cola.vacia()) {
+            activa = false;
+            return 0;
+        }
+        Estado actual = cola.extraerMin();
+        resultado.extracciones++;
+        if (actual.nodo == meta) {
+            reconstruirCamino(espacio, meta, resultado.camino);
+            resultado.costo = espacio.distancia(meta);
+            activa = false;
+            return 0;
+        }
+        float distanciaActual = espacio.distancia(actual.nodo);
+        if (actual.costo > distanciaActual + heuristica(actual.nodo, meta)) {
+            estadisticas.descartar();
+            return 0;
+        }
+        resultado.nodosVisitados.push_back(actual.nodo);
+        estadisticas.expandir();
+
+        auto mejorar = [&](int siguiente, float nuevoCosto) {
+            espacio.fijar(siguiente, nuevoCosto, actual.nodo);
+            cola.insertar(siguiente, nuevoCosto + heuristica(siguiente, meta));
+            estadisticas.insertar(cola.tamano());
+        };
+        if constexpr (std::is_same<G, GrafoCuadricula>::value) {
+            estadisticas.relajar(grafo.paraCadaMejora(espacio, actual.nodo, distanciaActual, mejorar));
+        } else {
+            grafo.paraCadaVecino(actual.nodo, [&](int siguiente, float costo) {
+                estadisticas.relajar();
+                float nuevoCosto = distanciaActual + costo;
+                if (nuevoCosto < espacio.distancia(siguiente)) mejorar(siguiente, nuevoCosto);
+            });
+        }
+        return 1;
+    }
+
+    const G& grafo;
+    EspacioBusqueda& espacio;
+    Heuristica heuristica;
+    ResultadoBusqueda resultado;
+    int meta = -1;
+    bool activa = false;
+};
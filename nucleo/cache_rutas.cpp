@@ -0,0 +1,163 @@
+#include "cache_rutas.h"
+
+#include <algorithm>
+
+using namespace std;
+
+CacheRutas::CacheRutas(const GrafoCuadricula& grafo, size_t capacidad, int ladoRegion)
+    : columnas(grafo.obtenerColumnas()),
+      ladoRegion(max(ladoRegion, 1)),
+      regionesPorFila((columnas + this->ladoRegion - 1) / this->ladoRegion),
+      costoRecto(0),
+      costoDiagonal(0),
+      heuristica(crearHeuristica(grafo, TipoHeuristica::Octil)),
+      capacidad(max(capacidad, (size_t)1)) {
+    for (int k = 0; k < 8; k++) {
+        if (GrafoCuadricula::DX[k] != 0 && GrafoCuadricula::DY[k] != 0) costoDiagonal = grafo.costoDireccion(k);
+        else costoRecto = grafo.costoDireccion(k);
+    }
+    int regionesPorColumna = (grafo.obtenerFilas() + this->ladoRegion - 1) / this->ladoRegion;
+    versionRegion.assign((size_t)regionesPorFila * regionesPorColumna, 0);
+}
+
+int CacheRutas::regionDe(int celda) const {
+    return (celda / columnas) / ladoRegion * regionesPorFila + (celda % columnas) / ladoRegion;
+}
+
+bool CacheRutas::valida(const Entrada& entrada) const {
+    for (int region : entrada.regiones) {
+        if (versionRegion[region] > entrada.version) return false;
+    }
+    return true;
+}
+
+void CacheRutas::descartar(Posicion posicion) {
+    indice.erase(clave(posicion->inicio, posicion->meta));
+    auto rango = porMeta.equal_range(posicion->meta);
+    for (auto it = rango.first; it != rango.second; ++it) {
+        if (it->second == posicion) {
+            porMeta.erase(it);
+            break;
+        }
+    }
+    entradas.erase(posicion);
+}
+
+// Sumado desde el inicio del tramo, en el mismo orden que la busqueda
+float CacheRutas::costoTramo(const vector<int>& camino, size_t desde) const {
+    float costo = 0;
+    for (size_t i = desde + 1; i < camino.size(); i++) {
+        bool diagonal = camino[i] % columnas != camino[i - 1] % columnas &&
+                        camino[i] / columnas != camino[i - 1] / columnas;
+        costo += diagonal ? costoDiagonal : costoRecto;
+    }
+    return costo;
+}
+
+bool CacheRutas::buscar(int inicio, int meta, ResultadoBusqueda& resultado) {
+    estadisticas.consultas++;
+    auto encontrada = indice.find(clave(inicio, meta));
+    if (encontrada != indice.end()) {
+        Posicion posicion = encontrada->second;
+        if (valida(*posicion)) {
+            entradas.splice(entradas.begin(), entradas, posicion);
+            resultado.camino = posicion->camino;
+            resultado.costo = posicion->costo;
+            resultado.nodosVisitados.clear();
+            resultado.extracciones = 0;
+            resultado.estadisticas = EstadisticasBusqueda();
+            estadisticas.aciertos++;
+            return true;
+        }
+        descartar(posicion);
+        estadisticas.invalidadas++;
+    }
+
+    // Tramo final de otra ruta a la misma meta que pase por el inicio
+    auto rango = porMeta.equal_range(meta);
+    for (auto it = rango.first; it != rango.second;) {
+        Posicion posicion = it->second;
+        ++it;
+        const vector<int>& camino = posicion->camino;
+        auto desde = find(camino.begin(), camino.end(), inicio);
+        if (desde == camino.end()) continue;
+        if (!valida(*posicion)) {
+            // Borrar del multimapa solo invalida el elemento borrado
+            descartar(posicion);
+            estadisticas.invalidadas++;
+            continue;
+        }
+        entradas.splice(entradas.begin(), entradas, posicion);
+        resultado.camino.assign(desde, camino.end());
+        resultado.costo = costoTramo(camino, desde - camino.begin());
+        resultado.nodosVisitados.clear();
+        resultado.extracciones = 0;
+        resultado.estadisticas = EstadisticasBusqueda();
+        estadisticas.aciertos++;
+        estadisticas.parciales++;
+        return true;
+    }
+    return false;
+}
+
+void CacheRutas::guardar(int inicio, int meta, const ResultadoBusqueda& resultado, uint64_t version) {
+    if (version < versionMinima) return;
+    auto encontrada = indice.find(clave(inicio, meta));
+    if (encontrada != indice.end()) descartar(encontrada->second);
+    while (entradas.size() >= capacidad) {
+        descartar(prev(entradas.end()));
+        estadisticas.desalojadas++;
+    }
+
+    Entrada entrada{inicio, meta, resultado.costo, version, resultado.camino, {}};
+    // Las celdas seguidas suelen caer en la misma region
+    for (int celda : resultado.camino) {
+        int region = regionDe(celda);
+        if (entrada.regiones.empty() || entrada.regiones.back() != region) entrada.regiones.push_back(region);
+    }
+    sort(entrada.regiones.begin(), entrada.regiones.end());
+    entrada.regiones.erase(unique(entrada.regiones.begin(), entrada.regiones.end()), entrada.regiones.end());
+    entradas.push_front(move(entrada));
+    indice[clave(inicio, meta)] = entradas.begin();
+    porMeta.emplace(meta, entradas.begin());
+}
+
+void CacheRutas::notificarCambio(int celda, bool esObstaculo) {
+    version++;
+    if (esObstaculo) {
+        versionRegion[regionDe(celda)] = version;
+        return;
+    }
+    // Una celda libre nueva puede acortar rutas que no la cruzan
+    versionMinima = version;
+    for (Posicion posicion = entradas.begin(); posicion != entradas.end();) {
+        Posicion siguiente = next(posicion);
+        if (posicion->camino.empty() ||
+            heuristica(posicion->inicio, celda) + heuristica(celda, posicion->meta) < posicion->costo) {
+            descartar(posicion);
+            estadisticas.invalidadas++;
+        }
+        posicion = siguiente;
+    }
+}
+
+void CacheRutas::vaciar() {
+    version++;
+    versionMinima = version;
+    entradas.clear();
+    indice.clear();
+    porMeta.clear();
+}
+
+size_t CacheRutas::bytes() const {
+    size_t total = versionRegion.capacity() * sizeof(uint64_t) +
+                   indice.size() * (sizeof(uint64_t) + sizeof(Posicion) + sizeof(void*)) +
+                   indice.bucket_count() * sizeof(void*) +
+                   porMeta.size() * (sizeof(int) + sizeof(Posicion) + sizeof(void*)) +
+                   porMeta.bucket_count() * sizeof(void*);
+    for (const Entrada& entrada : entradas) {
+        total += sizeof(Entrada) + 2 * sizeof(void*) + entrada.camino.capacity() * sizeof(int) +
+                 entrada.regiones.capacity() * sizeof(int);
+    }
+    return total;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "dijkstra.h"
+#include "grafo_cuadricula.h"
+#include "heuristica.h"
+
+// Rutas ya calculadas por (inicio, meta), con reemplazo LRU, para que las
+// consultas repetidas sean una busqueda en una tabla. Tambien responde con
+// el tramo final de una ruta guardada cuando el inicio pedido esta sobre
+// ella y la meta es la misma (un agente que vuelve a pedir la ruta a mitad
+// de camino): un tramo de una ruta optima tambien es optimo.
+//
+// Invalidacion por regiones de ladoRegion x ladoRegion celdas. Cada ruta
+// recuerda la version del mapa con la que se guardo y las regiones que
+// cruza. Al poner un obstaculo solo se sube la version de su region, y las
+// rutas que la cruzan dejan de valer al buscarlas; las demas siguen siendo
+// validas y optimas, porque un obstaculo nuevo no acorta nada. Al quitar un
+// obstaculo cualquier ruta podria acortarse, asi que se descartan en el
+// momento las que podrian pasar por la celda con menor costo (distancia
+// octil inicio-celda-meta menor que su costo) y las guardadas sin ruta.
+//
+// Las rutas de HPA* o A* ponderado se guardan como llegan: no son optimas y
+// al quitar obstaculos pueden seguir en la cache aunque haya otra mejor.
+class CacheRutas {
+public:
+    struct Estadisticas {
+        long long consultas = 0;
+        long long aciertos = 0;     // incluye los parciales
+        long long parciales = 0;    // respondidas con el tramo final de otra ruta
+        long long invalidadas = 0;  // descartadas por cambios en el mapa
+        long long desalojadas = 0;  // descartadas por falta de lugar
+
+        double tasaAciertos() const { return consultas ? (double)aciertos / consultas : 0; }
+    };
+
+    explicit CacheRutas(const GrafoCuadricula& grafo, size_t capacidad = 256, int ladoRegion = 16);
+
+    // Si hay una ruta valida, deja camino y costo en resultado (sin nodos
+    // visitados ni estadisticas de busqueda) y devuelve true.
+    bool buscar(int inicio, int meta, ResultadoBusqueda& resultado);
+
+    // version es la del mapa cuando se pidio la busqueda (obtenerVersion());
+    // si desde entonces se quito algun obstaculo o se vacio la cache, la ruta
+    // no se guarda.
+    void guardar(int inicio, int meta, const ResultadoBusqueda& resultado, uint64_t version);
+    void guardar(int inicio, int meta, const ResultadoBusqueda& resultado) {
+        guardar(inicio, meta, resultado, version);
+    }
+
+    // Llamar despues de cambiar la celda en el grafo.
+    void notificarCambio(int celda, bool esObstaculo);
+    // Descarta todo, por ejemplo al cambiar de algoritmo o de mapa.
+    void vaciar();
+
+    uint64_t obtenerVersion() const { return version; }
+    size_t tamano() const { return entradas.size(); }
+    const Estadisticas& obtenerEstadisticas() const { return estadisticas; }
+    size_t bytes() const;
+
+private:
+    struct Entrada {
+        int inicio;
+        int meta;
+        float costo;
+        uint64_t version;
+        std::vector<int> camino;
+        std::vector<int> regiones;  // ordenadas, sin repetir
+    };
+    using Posicion = std::list<Entrada>::iterator;
+
+    static uint64_t clave(int inicio, int meta) { return (uint64_t)(uint32_t)inicio << 32 | (uint32_t)meta; }
+    int regionDe(int celda) const;
+    bool valida(const Entrada& entrada) const;
+    void descartar(Posicion posicion);
+    float costoTramo(const std::vector<int>& camino, size_t desde) const;
+
+    int columnas;
+    int ladoRegion;
+    int regionesPorFila;
+    float costoRecto;
+    float costoDiagonal;
+    Heuristica heuristica;
+    size_t capacidad;
+
+    // La mas usada primero
+    std::list<Entrada> entradas;
+    std::unordered_map<uint64_t, Posicion> indice;
+    std::unordered_multimap<int, Posicion> porMeta;  // para los tramos finales, sin recorrer toda la lista
+
+    uint64_t version = 1;                 // sube con cada cambio del mapa
+    uint64_t versionMinima = 0;           // las busquedas pedidas antes no se guardan
+    std::vector<uint64_t> versionRegion;  // version del ultimo obstaculo puesto en cada region
+    Estadisticas estadisticas;
+};
@@ -0,0 +1,20 @@
+#include "campo_flujo.h"
+
+using namespace std;
+
+void CampoFlujo::calcularDirecciones(int columnas) {
+    int n = (int)campo.desde.size();
+    direcciones.resize(n);
+    for (int nodo = 0; nodo < n; nodo++) {
+        int siguiente = campo.desde[nodo];
+        if (siguiente == -1) {
+            direcciones[nodo] = SIN_DIRECCION;
+            continue;
+        }
+        int dx = siguiente % columnas - nodo % columnas;
+        int dy = siguiente / columnas - nodo / columnas;
+        // Mismo orden que GrafoCuadricula::DX/DY, sin la celda central
+        int k = (dx + 1) * 3 + dy + 1;
+        direcciones[nodo] = (uint8_t)(k > 4 ? k - 1 : k);
+    }
+}
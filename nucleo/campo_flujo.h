@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "delta_stepping.h"
+#include "grafo_cuadricula.h"
+
+// Campo de flujo hacia una meta compartida: una sola busqueda inversa desde
+// la meta deja en cada celda la distancia que falta y el siguiente paso, asi
+// cualquier cantidad de agentes se mueve leyendo su celda, sin buscar rutas.
+// Supone aristas simetricas, como en la cuadricula de 8 vecinos entre celdas
+// libres. Las celdas que no llegan a la meta (u obstaculos) valen INFINITO y
+// no tienen siguiente paso.
+class CampoFlujo {
+public:
+    static const int SIN_DIRECCION = 8;
+
+    // Con hilos la busqueda es delta-stepping; el campo sale igual.
+    template <class G>
+    void calcular(const G& grafo, int meta, GrupoHilos* hilos = nullptr) {
+        if (hilos) deltaStepping(grafo, *hilos, meta, 0, campo);
+        else campoDistancias(grafo, meta, campo);
+        this->meta = meta;
+        calcularDirecciones(grafo.obtenerColumnas());
+    }
+
+    bool valido() const { return meta != -1; }
+    int obtenerMeta() const { return meta; }
+    void invalidar() { meta = -1; }
+
+    float distancia(int nodo) const { return campo.distancias[nodo]; }
+    // -1 en la meta y en las celdas sin camino
+    int siguiente(int nodo) const { return campo.desde[nodo]; }
+    // Indice en GrafoCuadricula::DX/DY, o SIN_DIRECCION
+    int direccion(int nodo) const { return direcciones[nodo]; }
+
+    const std::vector<float>& obtenerDistancias() const { return campo.distancias; }
+    const std::vector<uint8_t>& obtenerDirecciones() const { return direcciones; }
+
+    size_t bytes() const {
+        return campo.distancias.capacity() * sizeof(float) + campo.desde.capacity() * sizeof(int) +
+               direcciones.capacity();
+    }
+
+private:
+    void calcularDirecciones(int columnas);
+
+    int meta = -1;
+    CampoDistancias campo;
+    std::vector<uint8_t> direcciones;
+};
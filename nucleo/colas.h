@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+struct Estado {
+    int nodo;
+    float costo;
+    Estado(int n, float c) : nodo(n), costo(c) {}
+    bool operator<(const Estado& otro) const {
+        return costo > otro.costo;
+    }
+};
+
+// Colas de prioridad intercambiables para la busqueda. Todas ofrecen:
+//   reservar(totalNodos), limpiar(), vacia(), tamano(), insertar(nodo, prioridad),
+//   extraerMin() -> Estado, bytes()
+// insertar puede dejar duplicados (colas perezosas) o bajar la prioridad
+// del nodo ya encolado (decrease-key); el buscador descarta los obsoletos.
+
+// Monticulo binario con borrado perezoso, como el priority_queue del
+// dijkstra original, pero conserva su memoria entre consultas.
+class ColaBinaria {
+public:
+    void reservar(int) {}
+    void limpiar() { elementos.clear(); }
+    bool vacia() const { return elementos.empty(); }
+    size_t tamano() const { return elementos.size(); }
+    const Estado& minimo() const { return elementos.front(); }
+    size_t bytes() const { return elementos.capacity() * sizeof(Estado); }
+    void insertar(int nodo, float prioridad) {
+        elementos.push_back(Estado(nodo, prioridad));
+        std::push_heap(elementos.begin(), elementos.end());
+    }
+    Estado extraerMin() {
+        std::pop_heap(elementos.begin(), elementos.end());
+        Estado minimo = elementos.back();
+        elementos.pop_back();
+        return minimo;
+    }
+
+private:
+    std::vector<Estado> elementos;
+};
+
+// Monticulo 4-ario indexado: cada nodo aparece a lo sumo una vez y
+// insertar hace decrease-key, asi que no hay extracciones obsoletas.
+template <class Clave = float>
+class MonticuloCuaternario {
+public:
+    void reservar(int totalNodos) {
+        if ((int)posiciones.size() < totalNodos) posiciones.resize(totalNodos, -1);
+    }
+
+    void limpiar() {
+        for (auto& elemento : elementos) posiciones[elemento.nodo] = -1;
+        elementos.clear();
+    }
+
+    bool vacia() const { return elementos.empty(); }
+    size_t tamano() const { return elementos.size(); }
+    bool contiene(int nodo) const { return posiciones[nodo] != -1; }
+    size_t bytes() const { return elementos.capacity() * sizeof(Elemento) + posiciones.capacity() * sizeof(int); }
+
+    int superior() const { return elementos[0].nodo; }
+    const Clave& prioridadSuperior() const { return elementos[0].prioridad; }
+
+    // Inserta o baja la prioridad; una prioridad mayor se ignora.
+    void insertar(int nodo, const Clave& prioridad) {
+        int i = posiciones[nodo];
+        if (i == -1) {
+            elementos.push_back({prioridad, nodo});
+            posiciones[nodo] = (int)elementos.size() - 1;
+            subir((int)elementos.size() - 1);
+        } else if (prioridad < elementos[i].prioridad) {
+            elementos[i].prioridad = prioridad;
+            subir(i);
+        }
+    }
+
+    // Cambia la prioridad en cualquier sentido (o inserta).
+    void actualizar(int nodo, const Clave& prioridad) {
+        int i = posiciones[nodo];
+        if (i == -1) {
+            insertar(nodo, prioridad);
+            return;
+        }
+        bool baja = prioridad < elementos[i].prioridad;
+        elementos[i].prioridad = prioridad;
+        if (baja) subir(i);
+        else bajar(i);
+    }
+
+    void quitar(int nodo) {
+        int i = posiciones[nodo];
+        if (i == -1) return;
+        posiciones[nodo] = -1;
+        Elemento movido = elementos.back();
+        elementos.pop_back();
+        if (i == (int)elementos.size()) return;
+        colocar(i, movido);
+        if (i > 0 && movido.prioridad < elementos[(i - 1) / 4].prioridad) subir(i);
+        else bajar(i);
+    }
+
+    void eliminarSuperior() { quitar(elementos[0].nodo); }
+
+    Estado extraerMin() {
+        Estado minimo(elementos[0].nodo, elementos[0].prioridad);
+        eliminarSuperior();
+        return minimo;
+    }
+
+private:
+    struct Elemento {
+        Clave prioridad;
+        int nodo;
+    };
+
+    void colocar(int i, const Elemento& elemento) {
+        elementos[i] = elemento;
+        posiciones[elemento.nodo] = i;
+    }
+
+    void subir(int i) {
+        Elemento elemento = elementos[i];
+        while (i > 0) {
+            int padre = (i - 1) / 4;
+            if (!(elemento.prioridad < elementos[padre].prioridad)) break;
+            colocar(i, elementos[padre]);
+            i = padre;
+        }
+        colocar(i, elemento);
+    }
+
+    void bajar(int i) {
+        Elemento elemento = elementos[i];
+        int total = (int)elementos.size();
+        while (true) {
+            int primero = 4 * i + 1;
+            if (primero >= total) break;
+            int menor = primero;
+            int ultimo = std::min(primero + 4, total);
+            for (int hijo = primero + 1; hijo < ultimo; hijo++) {
+                if (elementos[hijo].prioridad < elementos[menor].prioridad) menor = hijo;
+            }
+            if (!(elementos[menor].prioridad < elemento.prioridad)) break;
+            colocar(i, elementos[menor]);
+            i = menor;
+        }
+        colocar(i, elemento);
+    }
+
+    std::vector<Elemento> elementos;
+    std::vector<int> posiciones;
+};
+
+// Monticulo radix monotono sobre los bits del float: para costos no
+// negativos el orden de los bits coincide con el orden numerico. Exige que
+// ninguna prioridad insertada sea menor que la ultima extraida (Dijkstra
+// y A* con heuristica consistente); lo que llegue por debajo por redondeo
+// se ubica como si valiera el ultimo valor extraido, pero se devuelve con
+// su prioridad original. Perezoso como ColaBinaria.
+class MonticuloRadix {
+public:
+    void reservar(int) {}
+
+    void limpiar() {
+        for (auto& cubeta : cubetas) cubeta.clear();
+        ultimo = 0;
+        total = 0;
+    }
+
+    bool vacia() const { return total == 0; }
+    size_t tamano() const { return total; }
+    size_t bytes() const {
+        size_t suma = 0;
+        for (auto& cubeta : cubetas) suma += cubeta.capacity() * sizeof(Elemento);
+        return suma;
+    }
+
+    void insertar(int nodo, float prioridad) {
+        uint32_t clave = std::max(bits(prioridad), ultimo);
+        cubetas[cubeta(clave)].push_back({clave, prioridad, nodo});
+        total++;
+    }
+
+    Estado extraerMin() {
+        if (cubetas[0].empty()) {
+            int i = 1;
+            while (cubetas[i].empty()) i++;
+            // El nuevo minimo reparte la cubeta i en cubetas mas bajas
+            uint32_t minimo = cubetas[i][0].clave;
+            for (auto& elemento : cubetas[i]) minimo = std::min(minimo, elemento.clave);
+            ultimo = minimo;
+            for (auto& elemento : cubetas[i]) cubetas[cubeta(elemento.clave)].push_back(elemento);
+            cubetas[i].clear();
+        }
+        Elemento elemento = cubetas[0].back();
+        cubetas[0].pop_back();
+        total--;
+        return Estado(elemento.nodo, elemento.prioridad);
+    }
+
+private:
+    struct Elemento {
+        uint32_t clave;
+        float prioridad;
+        int nodo;
+    };
+
+    static uint32_t bits(float valor) {
+        uint32_t resultado;
+        std::memcpy(&resultado, &valor, sizeof(resultado));
+        return resultado;
+    }
+
+    int cubeta(uint32_t clave) const {
+        return clave == ultimo ? 0 : 32 - __builtin_clz(clave ^ ultimo);
+    }
+
+    std::vector<Elemento> cubetas[33];
+    uint32_t ultimo = 0;
+    size_t total = 0;
+};
@@ -0,0 +1,390 @@
+#include "contraccion.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+// Busquedas de testigos: se cortan al superar este numero de nodos asentados
+// o al asentar todos los destinos. Un testigo que no se encuentra solo
+// agrega un atajo de mas. Para estimar prioridades basta con una busqueda
+// mas corta y limitada en saltos (ver saltosPrioridad).
+const int MAX_ASENTADOS = 1000;
+const int MAX_ASENTADOS_PRIORIDAD = 30;
+// Un testigo apenas mas largo que el atajo por redondeo tambien sirve: en
+// la cuadricula hay muchos caminos del mismo costo sumados en otro orden.
+const float TOLERANCIA_TESTIGO = 1e-6f;
+
+struct Arco {
+    int nodo;
+    float costo;
+    int medio;
+};
+
+class Contractor {
+public:
+    Contractor(const Grafo& grafo, const atomic<bool>* cancelacion)
+        : salientes(grafo.totalNodos()), entrantes(grafo.totalNodos()), cancelacion(cancelacion),
+          vecinosContraidos(grafo.totalNodos(), 0), nivel(grafo.totalNodos(), 0),
+          destino(grafo.totalNodos(), 0), saltos(grafo.totalNodos(), 0) {
+        for (int u = 0; u < grafo.totalNodos(); u++) {
+            for (int arista = grafo.inicios[u]; arista < grafo.inicios[u + 1]; arista++) {
+                agregarArco(u, grafo.destinos[arista], grafo.costos[arista], -1);
+            }
+        }
+    }
+
+    // Contrae todos los nodos y devuelve el rango de cada uno.
+    vector<int> contraer() {
+        int total = (int)salientes.size();
+        restantes = total;
+        vector<int> rango(total, -1);
+        MonticuloCuaternario<float> cola;
+        cola.reservar(total);
+        for (int v = 0; v < total && !cancelada(); v++) cola.insertar(v, prioridad(v));
+
+        int orden = 0;
+        vector<int> vecinos;
+        while (!cola.vacia() && !cancelada()) {
+            // La prioridad del minimo puede haber quedado vieja por atajos de
+            // nodos que no eran vecinos: se recalcula y, si deja de ser el
+            // minimo, se vuelve a intentar.
+            int v = cola.superior();
+            cola.actualizar(v, prioridad(v));
+            if (cola.superior() != v) continue;
+            cola.eliminarSuperior();
+
+            atajosNecesarios(v, MAX_ASENTADOS, total, [&](int u, int w, float costo) { agregarArco(u, w, costo, v); });
+            rango[v] = orden++;
+            vecinos.clear();
+            for (const Arco& arco : entrantes[v]) {
+                quitarArco(salientes[arco.nodo], v);
+                vecinos.push_back(arco.nodo);
+            }
+            for (const Arco& arco : salientes[v]) {
+                quitarArco(entrantes[arco.nodo], v);
+                vecinos.push_back(arco.nodo);
+            }
+            restantes--;
+            arcosRestantes -= 2 * (long long)(entrantes[v].size() + salientes[v].size());
+            sort(vecinos.begin(), vecinos.end());
+            vecinos.erase(unique(vecinos.begin(), vecinos.end()), vecinos.end());
+            // Los vecinos cambiaron de grado y de atajos: se actualizan ya
+            for (int u : vecinos) {
+                vecinosContraidos[u]++;
+                nivel[u] = max(nivel[u], nivel[v] + 1);
+                cola.actualizar(u, prioridad(u));
+            }
+        }
+        return rango;
+    }
+
+    // Al contraer v sus listas solo tienen nodos de rango mayor: son sus
+    // aristas hacia arriba y las que bajan hacia el.
+    vector<vector<Arco>> salientes;
+    vector<vector<Arco>> entrantes;
+
+private:
+    void agregarArco(int desde, int hacia, float costo, int medio) {
+        for (Arco& arco : salientes[desde]) {
+            if (arco.nodo != hacia) continue;
+            if (costo < arco.costo) {
+                arco = {hacia, costo, medio};
+                for (Arco& inverso : entrantes[hacia]) {
+                    if (inverso.nodo == desde) inverso = {desde, costo, medio};
+                }
+            }
+            return;
+        }
+        salientes[desde].push_back({hacia, costo, medio});
+        entrantes[hacia].push_back({desde, costo, medio});
+        arcosRestantes += 2;
+    }
+
+    static void quitarArco(vector<Arco>& arcos, int nodo) {
+        for (size_t i = 0; i < arcos.size(); i++) {
+            if (arcos[i].nodo == nodo) {
+                arcos[i] = arcos.back();
+                arcos.pop_back();
+                return;
+            }
+        }
+    }
+
+    // Dijkstra desde origen por el grafo que queda, sin pasar por evitar ni
+    // por caminos de mas de maxSaltos arcos. Termina al asentar los
+    // pendientes nodos marcados en destino.
+    void buscarTestigos(int origen, int evitar, float limite, int maxAsentados, int pendientes, int maxSaltos) {
+        ColaBinaria& cola = espacio.colaBinaria;
+        espacio.preparar((int)salientes.size());
+        cola.limpiar();
+        espacio.fijar(origen, 0, -1);
+        saltos[origen] = 0;
+        cola.insertar(origen, 0);
+        int asentados = 0;
+        while (!cola.vacia() && asentados < maxAsentados && pendientes > 0) {
+            Estado actual = cola.extraerMin();
+            float distanciaActual = espacio.distancia(actual.nodo);
+            if (actual.costo > distanciaActual) continue;
+            if (distanciaActual > limite) break;
+            asentados++;
+            if (destino[actual.nodo] == marca) pendientes--;
+            if (saltos[actual.nodo] >= maxSaltos) continue;
+            for (const Arco& arco : salientes[actual.nodo]) {
+                if (arco.nodo == evitar) continue;
+                float nuevoCosto = distanciaActual + arco.costo;
+                if (nuevoCosto < espacio.distancia(arco.nodo)) {
+                    espacio.fijar(arco.nodo, nuevoCosto, actual.nodo);
+                    saltos[arco.nodo] = saltos[actual.nodo] + 1;
+                    cola.insertar(arco.nodo, nuevoCosto);
+                }
+            }
+        }
+    }
+
+    // Llama alAgregar(u, w, costo) por cada atajo u -> w que haria falta al
+    // contraer v y devuelve cuantos son.
+    template <class F>
+    int atajosNecesarios(int v, int maxAsentados, int maxSaltos, F&& alAgregar) {
+        float maximoSaliente = 0;
+        ++marca;
+        for (const Arco& arco : salientes[v]) {
+            maximoSaliente = max(maximoSaliente, arco.costo);
+            destino[arco.nodo] = marca;
+        }
+
+        int total = 0;
+        for (size_t i = 0; i < entrantes[v].size(); i++) {
+            Arco entrante = entrantes[v][i];
+            int pendientes = (int)salientes[v].size() - (destino[entrante.nodo] == marca);
+            if (pendientes == 0) continue;
+            buscarTestigos(entrante.nodo, v, (entrante.costo + maximoSaliente) * (1 + TOLERANCIA_TESTIGO),
+                           maxAsentados, pendientes, maxSaltos);
+            for (size_t j = 0; j < salientes[v].size(); j++) {
+                Arco saliente = salientes[v][j];
+                if (saliente.nodo == entrante.nodo) continue;
+                float costo = entrante.costo + saliente.costo;
+                if (espacio.distancia(saliente.nodo) <= costo * (1 + TOLERANCIA_TESTIGO)) continue;
+                alAgregar(entrante.nodo, saliente.nodo, costo);
+                total++;
+            }
+        }
+        return total;
+    }
+
+    // Diferencia de aristas, vecinos ya contraidos y profundidad en la
+    // jerarquia, para repartir la contraccion por todo el mapa.
+    float prioridad(int v) {
+        int atajos = atajosNecesarios(v, MAX_ASENTADOS_PRIORIDAD, saltosPrioridad(), [](int, int, float) {});
+        int quitadas = (int)(entrantes[v].size() + salientes[v].size());
+        return (float)(2 * (atajos - quitadas) + vecinosContraidos[v] + nivel[v]);
+    }
+
+    // Mientras el grafo que queda es ralo los testigos estan a uno o dos
+    // arcos; a medida que se densifica hacen falta caminos mas largos.
+    int saltosPrioridad() const {
+        float grado = restantes ? (float)arcosRestantes / restantes : 0;
+        return grado < 14 ? 1 : grado < 25 ? 2 : grado < 40 ? 3 : 5;
+    }
+
+    bool cancelada() const { return cancelacion && cancelacion->load(memory_order_relaxed); }
+
+    const atomic<bool>* cancelacion;
+    int restantes = 0;
+    long long arcosRestantes = 0;  // entrantes + salientes sumados sobre los nodos sin contraer
+    vector<int> vecinosContraidos;
+    vector<int> nivel;         // largo de la cadena de contracciones que llega al nodo
+    vector<uint32_t> destino;  // == marca: destino de la busqueda de testigos actual
+    uint32_t marca = 0;
+    vector<int> saltos;
+    EspacioBusqueda espacio;
+};
+
+// CSR con los arcos de cada nodo en el orden en que quedaron.
+void construirCSR(const vector<vector<Arco>>& arcos, Grafo& grafo, vector<int>& medios) {
+    grafo.inicios.assign(arcos.size() + 1, 0);
+    for (size_t u = 0; u < arcos.size(); u++) grafo.inicios[u + 1] = grafo.inicios[u] + (int)arcos[u].size();
+    grafo.destinos.resize(grafo.inicios.back());
+    grafo.costos.resize(grafo.inicios.back());
+    medios.resize(grafo.inicios.back());
+    for (size_t u = 0; u < arcos.size(); u++) {
+        int i = grafo.inicios[u];
+        for (const Arco& arco : arcos[u]) {
+            grafo.destinos[i] = arco.nodo;
+            grafo.costos[i] = arco.costo;
+            medios[i] = arco.medio;
+            i++;
+        }
+    }
+}
+
+// Ordena los arcos de cada nodo por destino, con sus medios, para que
+// medioDe los encuentre por busqueda binaria.
+void ordenarPorDestino(Grafo& grafo, vector<int>& medios) {
+    vector<tuple<int, float, int>> arcos;
+    for (int u = 0; u + 1 < (int)grafo.inicios.size(); u++) {
+        int desde = grafo.inicios[u], hasta = grafo.inicios[u + 1];
+        if (is_sorted(grafo.destinos.begin() + desde, grafo.destinos.begin() + hasta)) continue;
+        arcos.clear();
+        for (int i = desde; i < hasta; i++) arcos.emplace_back(grafo.destinos[i], grafo.costos[i], medios[i]);
+        sort(arcos.begin(), arcos.end());
+        for (int i = desde; i < hasta; i++) tie(grafo.destinos[i], grafo.costos[i], medios[i]) = arcos[i - desde];
+    }
+}
+
+}  // namespace
+
+JerarquiaContraccion::JerarquiaContraccion(const Grafo& grafo, const atomic<bool>* cancelacion) {
+    Contractor contractor(grafo, cancelacion);
+    rango = contractor.contraer();
+    construirCSR(contractor.salientes, arriba, mediosArriba);
+    construirCSR(contractor.entrantes, abajo, mediosAbajo);
+    ordenarPorDestino(arriba, mediosArriba);
+    ordenarPorDestino(abajo, mediosAbajo);
+    contarAtajos();
+}
+
+JerarquiaContraccion::JerarquiaContraccion(vector<int> rango, Grafo arriba, Grafo abajo, vector<int> mediosArriba,
+                                           vector<int> mediosAbajo)
+    : rango(move(rango)), arriba(move(arriba)), abajo(move(abajo)), mediosArriba(move(mediosArriba)),
+      mediosAbajo(move(mediosAbajo)) {
+    // Los archivos escritos antes de ordenar los arcos tambien sirven
+    ordenarPorDestino(this->arriba, this->mediosArriba);
+    ordenarPorDestino(this->abajo, this->mediosAbajo);
+    contarAtajos();
+}
+
+// Cada atajo queda guardado una sola vez, en el extremo de menor rango
+void JerarquiaContraccion::contarAtajos() {
+    auto esAtajo = [](int medio) { return medio != -1; };
+    atajos = (int)(count_if(mediosArriba.begin(), mediosArriba.end(), esAtajo) +
+                   count_if(mediosAbajo.begin(), mediosAbajo.end(), esAtajo));
+}
+
+size_t JerarquiaContraccion::bytes() const {
+    return rango.size() * sizeof(int) + (arriba.inicios.size() + abajo.inicios.size()) * sizeof(int) +
+           (arriba.destinos.size() + abajo.destinos.size()) * (2 * sizeof(int) + sizeof(float));
+}
+
+// Medio del arco desde -> hacia: esta arriba en el de menor rango.
+int JerarquiaContraccion::medioDe(int desde, int hacia) const {
+    bool subiendo = rango[desde] < rango[hacia];
+    const Grafo& grafo = subiendo ? arriba : abajo;
+    const vector<int>& medios = subiendo ? mediosArriba : mediosAbajo;
+    int nodo = subiendo ? desde : hacia;
+    int buscado = subiendo ? hacia : desde;
+    auto primero = grafo.destinos.begin() + grafo.inicios[nodo];
+    auto ultimo = grafo.destinos.begin() + grafo.inicios[nodo + 1];
+    auto arista = lower_bound(primero, ultimo, buscado);
+    if (arista == ultimo || *arista != buscado) return -1;
+    return medios[arista - grafo.destinos.begin()];
+}
+
+// Agrega al camino los nodos de desde -> hacia sin incluir desde.
+void JerarquiaContraccion::desempaquetar(int desde, int hacia, vector<int>& camino) const {
+    vector<pair<int, int>> pendientes(1, {desde, hacia});
+    while (!pendientes.empty()) {
+        pair<int, int> tramo = pendientes.back();
+        pendientes.pop_back();
+        int medio = medioDe(tramo.first, tramo.second);
+        if (medio == -1) {
+            camino.push_back(tramo.second);
+            continue;
+        }
+        pendientes.push_back({medio, tramo.second});
+        pendientes.push_back({tramo.first, medio});
+    }
+}
+
+ResultadoBusqueda JerarquiaContraccion::buscar(EspacioBusqueda& espacio, int inicio, int meta) const {
+    ResultadoBusqueda resultado;
+    EstadisticasBusqueda& estadisticas = resultado.estadisticas;
+    if (inicio == meta) {
+        resultado.camino.push_back(inicio);
+        resultado.costo = 0;
+        return resultado;
+    }
+
+    EspacioBusqueda& atras = espacio.complementario();
+    EspacioBusqueda* espacios[2] = {&espacio, &atras};
+    const Grafo* subida[2] = {&arriba, &abajo};
+    const Grafo* bajada[2] = {&abajo, &arriba};
+    for (EspacioBusqueda* e : espacios) {
+        e->preparar(totalNodos());
+        e->colaBinaria.limpiar();
+    }
+    espacio.fijar(inicio, 0, -1);
+    espacio.colaBinaria.insertar(inicio, 0);
+    atras.fijar(meta, 0, -1);
+    atras.colaBinaria.insertar(meta, 0);
+    estadisticas.insertar(2);
+
+    float mejor = INFINITO;
+    int encuentro = -1;
+    while (!espacio.colaBinaria.vacia() || !atras.colaBinaria.vacia()) {
+        for (int lado = 0; lado < 2; lado++) {
+            EspacioBusqueda& propio = *espacios[lado];
+            const EspacioBusqueda& otro = *espacios[1 - lado];
+            ColaBinaria& cola = propio.colaBinaria;
+            if (cola.vacia()) continue;
+            // Cada sentido termina cuando su minimo ya no puede mejorar la ruta
+            if (cola.minimo().costo >= mejor) {
+                cola.limpiar();
+                continue;
+            }
+            Estado actual = cola.extraerMin();
+            resultado.extracciones++;
+            float distanciaActual = propio.distancia(actual.nodo);
+            if (actual.costo > distanciaActual) {
+                estadisticas.descartar();
+                continue;
+            }
+
+            if (otro.alcanzado(actual.nodo) && distanciaActual + otro.distancia(actual.nodo) < mejor) {
+                mejor = distanciaActual + otro.distancia(actual.nodo);
+                encuentro = actual.nodo;
+            }
+
+            // Stall-on-demand: si un nodo de rango mayor ya alcanzado llega
+            // mas barato, este nodo no puede estar en la ruta mas corta
+            const Grafo& inverso = *bajada[lado];
+            bool detenido = false;
+            for (int arista = inverso.inicios[actual.nodo]; arista < inverso.inicios[actual.nodo + 1]; arista++) {
+                if (propio.distancia(inverso.destinos[arista]) + inverso.costos[arista] < distanciaActual) {
+                    detenido = true;
+                    break;
+                }
+            }
+            if (detenido) continue;
+            resultado.nodosVisitados.push_back(actual.nodo);
+            estadisticas.expandir();
+
+            const Grafo& grafo = *subida[lado];
+            estadisticas.relajar(grafo.inicios[actual.nodo + 1] - grafo.inicios[actual.nodo]);
+            for (int arista = grafo.inicios[actual.nodo]; arista < grafo.inicios[actual.nodo + 1]; arista++) {
+                int siguiente = grafo.destinos[arista];
+                float nuevoCosto = distanciaActual + grafo.costos[arista];
+                if (nuevoCosto < propio.distancia(siguiente)) {
+                    propio.fijar(siguiente, nuevoCosto, actual.nodo);
+                    cola.insertar(siguiente, nuevoCosto);
+                    estadisticas.insertar(espacio.colaBinaria.tamano() + atras.colaBinaria.tamano());
+                }
+            }
+        }
+    }
+
+    if (encuentro == -1) return resultado;
+
+    // Ruta por la jerarquia: inicio -> encuentro subiendo, encuentro -> meta bajando
+    vector<int> jerarquica;
+    reconstruirCamino(espacio, encuentro, jerarquica);
+    for (int nodo = atras.padre(encuentro); nodo != -1; nodo = atras.padre(nodo)) jerarquica.push_back(nodo);
+
+    resultado.camino.push_back(inicio);
+    for (size_t i = 1; i < jerarquica.size(); i++) desempaquetar(jerarquica[i - 1], jerarquica[i], resultado.camino);
+    resultado.costo = mejor;
+    return resultado;
+}
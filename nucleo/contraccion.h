@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "dijkstra.h"
+#include "espacio_busqueda.h"
+#include "grafo.h"
+
+// Contraction Hierarchies para mapas estaticos. El preproceso contrae los
+// nodos de uno en uno (primero los que agregan menos atajos) y guarda, para
+// cada nodo, las aristas hacia nodos contraidos despues (arriba) y las que
+// llegan desde ellos (abajo). Una consulta es un Dijkstra bidireccional que
+// solo sube de rango, y los atajos se desempaquetan a nodos del grafo
+// original. Si cambian los obstaculos hay que volver a construirla.
+class JerarquiaContraccion {
+public:
+    // grafo debe contener solo aristas transitables (ver copiarAristas). Si
+    // se levanta cancelacion la construccion termina antes y la jerarquia
+    // queda incompleta: no sirve para buscar.
+    explicit JerarquiaContraccion(const Grafo& grafo, const std::atomic<bool>* cancelacion = nullptr);
+    // A partir de arreglos ya construidos (ver archivo_mapa.h).
+    JerarquiaContraccion(std::vector<int> rango, Grafo arriba, Grafo abajo, std::vector<int> mediosArriba,
+                         std::vector<int> mediosAbajo);
+
+    // nodosVisitados contiene los nodos asentados en ambos sentidos. Usa el
+    // espacio y su complementario.
+    ResultadoBusqueda buscar(EspacioBusqueda& espacio, int inicio, int meta) const;
+
+    int totalNodos() const { return (int)rango.size(); }
+    int totalAtajos() const { return atajos; }
+    int totalAristas() const { return arriba.totalAristas() + abajo.totalAristas(); }
+    size_t bytes() const;
+
+    const std::vector<int>& obtenerRango() const { return rango; }
+    const Grafo& obtenerArriba() const { return arriba; }
+    const Grafo& obtenerAbajo() const { return abajo; }
+    const std::vector<int>& obtenerMediosArriba() const { return mediosArriba; }
+    const std::vector<int>& obtenerMediosAbajo() const { return mediosAbajo; }
+
+private:
+    void contarAtajos();
+    int medioDe(int desde, int hacia) const;
+    void desempaquetar(int desde, int hacia, std::vector<int>& camino) const;
+
+    std::vector<int> rango;         // orden de contraccion
+    Grafo arriba;                   // u -> w con rango[w] > rango[u]
+    Grafo abajo;                    // en w, aristas u -> w con rango[u] > rango[w], guardadas como w -> u
+    std::vector<int> mediosArriba;  // nodo que reemplaza cada atajo, -1 si la arista es original
+    std::vector<int> mediosAbajo;
+    int atajos = 0;
+};
+
+// Copia a un CSR las aristas transitables de cualquier grafo con
+// paraCadaVecino (VistaGrafo o GrafoCuadricula).
+template <class G>
+Grafo copiarAristas(const G& grafo) {
+    ConstructorGrafo constructor(grafo.totalNodos(), grafo.totalNodos() * 8);
+    for (int nodo = 0; nodo < grafo.totalNodos(); nodo++) {
+        grafo.paraCadaVecino(nodo, [&](int vecino, float costo) { constructor.agregarArista(nodo, vecino, costo); });
+    }
+    return constructor.construir();
+}
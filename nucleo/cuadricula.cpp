@@ -0,0 +1,136 @@
+#include "cuadricula.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+using namespace std;
+
+Cuadricula::Cuadricula(int columnas, int filas, float espaciado)
+    : columnas(columnas), filas(filas), espaciado(espaciado), obstaculos(columnas, filas) {}
+
+Cuadricula generarCuadriculaAleatoria(int columnas, int filas, float espaciado, float densidad, unsigned semilla) {
+    Cuadricula cuadricula(columnas, filas, espaciado);
+    mt19937 generador(semilla);
+    bernoulli_distribution obstaculo(densidad);
+    for (int y = 0; y < filas; y++) {
+        for (int x = 0; x < columnas; x++) {
+            if (obstaculo(generador)) cuadricula.ponerObstaculo(x, y, true);
+        }
+    }
+    return cuadricula;
+}
+
+Cuadricula generarLaberinto(int columnas, int filas, float espaciado, unsigned semilla) {
+    Cuadricula cuadricula(columnas, filas, espaciado);
+    for (int y = 0; y < filas; y++) {
+        for (int x = 0; x < columnas; x++) cuadricula.ponerObstaculo(x, y, true);
+    }
+    if (columnas < 2 || filas < 2) return cuadricula;
+
+    // Las celdas de coordenadas pares son habitaciones; se abren los muros entre ellas
+    mt19937 generador(semilla);
+    const int DX[4] = {2, -2, 0, 0};
+    const int DY[4] = {0, 0, 2, -2};
+    vector<int> pila = {obtenerIndice(0, 0, columnas)};
+    cuadricula.ponerObstaculo(0, 0, false);
+    while (!pila.empty()) {
+        int actual = pila.back();
+        int x = actual % columnas;
+        int y = actual / columnas;
+        int opciones[4];
+        int totalOpciones = 0;
+        for (int k = 0; k < 4; k++) {
+            int nx = x + DX[k];
+            int ny = y + DY[k];
+            if (cuadricula.esValido(nx, ny) && cuadricula.esObstaculo(nx, ny)) {
+                opciones[totalOpciones++] = k;
+            }
+        }
+        if (totalOpciones == 0) {
+            pila.pop_back();
+            continue;
+        }
+        int k = opciones[uniform_int_distribution<int>(0, totalOpciones - 1)(generador)];
+        cuadricula.ponerObstaculo(x + DX[k] / 2, y + DY[k] / 2, false);
+        cuadricula.ponerObstaculo(x + DX[k], y + DY[k], false);
+        pila.push_back(obtenerIndice(x + DX[k], y + DY[k], columnas));
+    }
+    return cuadricula;
+}
+
+Cuadricula generarHabitaciones(int columnas, int filas, float espaciado, int lado, unsigned semilla) {
+    Cuadricula cuadricula(columnas, filas, espaciado);
+    lado = max(lado, 1);
+    int paso = lado + 1;
+    for (int y = 0; y < filas; y++) {
+        for (int x = 0; x < columnas; x++) {
+            if (x % paso == lado || y % paso == lado) cuadricula.ponerObstaculo(x, y, true);
+        }
+    }
+    // Cada habitacion tiene puerta hacia la de la derecha y la de abajo, asi
+    // que todas quedan conectadas
+    mt19937 generador(semilla);
+    for (int x = lado; x < columnas; x += paso) {
+        for (int y = 0; y < filas; y += paso) {
+            int puerta = uniform_int_distribution<int>(y, min(y + lado, filas) - 1)(generador);
+            cuadricula.ponerObstaculo(x, puerta, false);
+        }
+    }
+    for (int y = lado; y < filas; y += paso) {
+        for (int x = 0; x < columnas; x += paso) {
+            int puerta = uniform_int_distribution<int>(x, min(x + lado, columnas) - 1)(generador);
+            cuadricula.ponerObstaculo(puerta, y, false);
+        }
+    }
+    return cuadricula;
+}
+
+bool cargarMapa(const string& ruta, float espaciado, Cuadricula& salida) {
+    ifstream archivo(ruta);
+    if (!archivo) return false;
+
+    string clave;
+    int columnas = -1, filas = -1;
+    while (archivo >> clave && clave != "map") {
+        if (clave == "height") archivo >> filas;
+        else if (clave == "width") archivo >> columnas;
+        else archivo >> clave;  // "type octile"
+    }
+    if (clave != "map" || columnas <= 0 || filas <= 0) return false;
+
+    Cuadricula cuadricula(columnas, filas, espaciado);
+    string linea;
+    for (int y = 0; y < filas; y++) {
+        if (!(archivo >> linea) || (int)linea.size() < columnas) return false;
+        for (int x = 0; x < columnas; x++) {
+            char c = linea[x];
+            cuadricula.ponerObstaculo(x, y, !(c == '.' || c == 'G' || c == 'S'));
+        }
+    }
+    salida = move(cuadricula);
+    return true;
+}
+
+bool cargarEscenarios(const string& ruta, vector<ConsultaEscenario>& salida) {
+    ifstream archivo(ruta);
+    if (!archivo) return false;
+
+    // "version 1" y despues: cubeta mapa ancho alto x0 y0 x1 y1 optimo
+    string palabra;
+    if (!(archivo >> palabra)) return false;
+    if (palabra == "version") archivo >> palabra;
+    else archivo.seekg(0);
+
+    vector<ConsultaEscenario> consultas;
+    string mapa;
+    int cubeta;
+    ConsultaEscenario consulta;
+    while (archivo >> cubeta >> mapa >> consulta.columnas >> consulta.filas >> consulta.inicioX >> consulta.inicioY >>
+           consulta.metaX >> consulta.metaY >> consulta.optimo) {
+        consultas.push_back(consulta);
+    }
+    if (!archivo.eof() || consultas.empty()) return false;
+    salida = move(consultas);
+    return true;
+}
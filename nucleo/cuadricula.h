@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mapa_bits.h"
+
+inline int obtenerIndice(int x, int y, int columnas) {
+    return y * columnas + x;
+}
+
+struct Posicion {
+    float x = 0;
+    float y = 0;
+};
+
+// Malla uniforme de celdas. Solo se guardan los obstaculos; la posicion de
+// cada celda (su centro) se calcula a partir del indice.
+struct Cuadricula {
+    int columnas = 0;
+    int filas = 0;
+    float espaciado = 1;
+    MapaBits obstaculos;
+
+    Cuadricula() = default;
+    Cuadricula(int columnas, int filas, float espaciado);
+
+    int totalNodos() const { return columnas * filas; }
+
+    bool esValido(int x, int y) const {
+        return x >= 0 && y >= 0 && x < columnas && y < filas;
+    }
+
+    bool esObstaculo(int indice) const { return obstaculos.prueba(indice); }
+    bool esObstaculo(int x, int y) const { return obstaculos.prueba(x, y); }
+    void ponerObstaculo(int x, int y, bool valor) { obstaculos.poner(x, y, valor); }
+    void alternarObstaculo(int indice) { obstaculos.alternar(indice); }
+
+    Posicion posicion(int indice) const {
+        return {(indice % columnas) * espaciado + espaciado / 2.f, (indice / columnas) * espaciado + espaciado / 2.f};
+    }
+};
+
+Cuadricula generarCuadriculaAleatoria(int columnas, int filas, float espaciado, float densidad, unsigned semilla);
+
+// Laberinto de pasillos de una celda (backtracking aleatorio).
+Cuadricula generarLaberinto(int columnas, int filas, float espaciado, unsigned semilla);
+
+// Habitaciones de lado x lado celdas separadas por muros de una celda, con
+// una puerta al azar en cada tramo de muro entre dos habitaciones vecinas
+// (como los mapas "rooms" de MovingAI).
+Cuadricula generarHabitaciones(int columnas, int filas, float espaciado, int lado, unsigned semilla);
+
+// Lee un mapa en formato MovingAI (.map); '.', 'G' y 'S' son transitables.
+bool cargarMapa(const std::string& ruta, float espaciado, Cuadricula& salida);
+
+// Una linea de un archivo de escenarios MovingAI (.scen).
+struct ConsultaEscenario {
+    int columnas, filas;  // del mapa para el que se escribio
+    int inicioX, inicioY;
+    int metaX, metaY;
+    double optimo;        // en celdas, sin cortar esquinas
+};
+
+bool cargarEscenarios(const std::string& ruta, std::vector<ConsultaEscenario>& salida);
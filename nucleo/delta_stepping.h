@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "colas.h"
+#include "espacio_busqueda.h"
+#include "hilos.h"
+
+// Distancias desde un origen a todos los nodos. desde[v] es el predecesor en
+// el arbol de rutas mas cortas; si varios llegan con la misma distancia se
+// queda el de menor indice, asi el resultado no depende del orden en que se
+// expanden los nodos ni del numero de hilos.
+struct CampoDistancias {
+    std::vector<float> distancias;
+    std::vector<int> desde;
+};
+
+// Ancho de cubeta por defecto de deltaStepping, en multiplos del espaciado.
+const float CUBETA_POR_DEFECTO = 4;
+
+// Dijkstra secuencial sobre todo el grafo; es la referencia de deltaStepping.
+template <class G>
+void campoDistancias(const G& grafo, int origen, CampoDistancias& campo) {
+    int n = grafo.totalNodos();
+    campo.distancias.assign(n, INFINITO);
+    campo.desde.assign(n, -1);
+    ColaBinaria cola;
+    campo.distancias[origen] = 0;
+    cola.insertar(origen, 0);
+    while (!cola.vacia()) {
+        Estado actual = cola.extraerMin();
+        float distanciaActual = campo.distancias[actual.nodo];
+        if (actual.costo > distanciaActual) continue;
+        grafo.paraCadaVecino(actual.nodo, [&](int siguiente, float costo) {
+            float nuevoCosto = distanciaActual + costo;
+            if (nuevoCosto < campo.distancias[siguiente]) {
+                campo.distancias[siguiente] = nuevoCosto;
+                campo.desde[siguiente] = actual.nodo;
+                cola.insertar(siguiente, nuevoCosto);
+            } else if (nuevoCosto == campo.distancias[siguiente] && actual.nodo < campo.desde[siguiente]) {
+                campo.desde[siguiente] = actual.nodo;
+            }
+        });
+    }
+}
+
+// Delta-stepping paralelo (Meyer y Sanders, con cubetas locales por hilo).
+// Los nodos se agrupan en cubetas de ancho delta segun su distancia; todos
+// los de la cubeta mas baja se relajan en paralelo y los que mejoran van a
+// la cubeta que les toca, hasta vaciarla y pasar a la siguiente. Un delta
+// grande da mas paralelismo pero relaja mas veces los mismos nodos; con
+// delta <= 0 se usa CUBETA_POR_DEFECTO veces el espaciado del grafo.
+//
+// Distancia y predecesor se guardan juntos en 64 bits (los bits de un float
+// no negativo se ordenan igual que el numero), asi un minimo atomico decide
+// tambien el empate por el menor indice y el campo sale igual al de
+// campoDistancias.
+template <class G>
+void deltaStepping(const G& grafo, GrupoHilos& hilos, int origen, float delta, CampoDistancias& campo) {
+    // Por debajo de este tamano la cubeta se procesa en el hilo que llama
+    const int MINIMO_PARALELO = 512;
+
+    int n = grafo.totalNodos();
+    if (delta <= 0) delta = CUBETA_POR_DEFECTO * grafo.obtenerEspaciado();
+    float inversoDelta = 1 / delta;
+    auto empaquetar = [](float distancia, int padre) {
+        uint32_t bits;
+        std::memcpy(&bits, &distancia, sizeof(bits));
+        return (uint64_t)bits << 32 | (uint32_t)padre;
+    };
+    auto distanciaDe = [](uint64_t valor) {
+        uint32_t bits = (uint32_t)(valor >> 32);
+        float distancia;
+        std::memcpy(&distancia, &bits, sizeof(distancia));
+        return distancia;
+    };
+
+    std::vector<std::atomic<uint64_t>> estado(n);
+    hilos.paraCada(n, [&](int v, int) { estado[v].store(empaquetar(INFINITO, -1), std::memory_order_relaxed); });
+    estado[origen].store(empaquetar(0, -1), std::memory_order_relaxed);
+
+    int totalHilos = hilos.totalHilos();
+    std::vector<std::vector<std::vector<int>>> locales(totalHilos);
+    std::vector<int> frontera(1, origen);
+    size_t actual = 0;
+
+    auto relajar = [&](int u, int hilo) {
+        float distanciaU = distanciaDe(estado[u].load(std::memory_order_relaxed));
+        // Entrada obsoleta: u ya bajo a una cubeta anterior y se proceso alli
+        if ((size_t)(distanciaU * inversoDelta) < actual) return;
+        std::vector<std::vector<int>>& cubetas = locales[hilo];
+        grafo.paraCadaVecino(u, [&](int v, float costo) {
+            float nuevoCosto = distanciaU + costo;
+            uint64_t nuevo = empaquetar(nuevoCosto, u);
+            uint64_t viejo = estado[v].load(std::memory_order_relaxed);
+            while (nuevo < viejo && !estado[v].compare_exchange_weak(viejo, nuevo, std::memory_order_relaxed)) {
+            }
+            // Solo un cambio de distancia obliga a volver a relajar v
+            if (nuevo >= viejo || distanciaDe(viejo) == nuevoCosto) return;
+            size_t cubeta = (size_t)(nuevoCosto * inversoDelta);
+            if (cubeta >= cubetas.size()) cubetas.resize(cubeta + 1);
+            cubetas[cubeta].push_back(v);
+        });
+    };
+
+    while (!frontera.empty()) {
+        if ((int)frontera.size() < MINIMO_PARALELO || totalHilos == 1) {
+            for (int u : frontera) relajar(u, 0);
+        } else {
+            hilos.paraCada((int)frontera.size(), [&](int i, int hilo) { relajar(frontera[i], hilo); }, 64);
+        }
+
+        // Siguiente cubeta no vacia entre todos los hilos; puede ser la misma
+        // si alguna arista corta quedo dentro de ella
+        size_t siguiente = SIZE_MAX;
+        for (auto& cubetas : locales) {
+            for (size_t b = actual; b < cubetas.size() && b < siguiente; b++) {
+                if (!cubetas[b].empty()) {
+                    siguiente = b;
+                    break;
+                }
+            }
+        }
+        frontera.clear();
+        if (siguiente == SIZE_MAX) break;
+        actual = siguiente;
+        for (auto& cubetas : locales) {
+            if (actual >= cubetas.size()) continue;
+            frontera.insert(frontera.end(), cubetas[actual].begin(), cubetas[actual].end());
+            cubetas[actual].clear();
+        }
+    }
+
+    campo.distancias.resize(n);
+    campo.desde.resize(n);
+    hilos.paraCada(n, [&](int v, int) {
+        uint64_t valor = estado[v].load(std::memory_order_relaxed);
+        campo.distancias[v] = distanciaDe(valor);
+        campo.desde[v] = (int)(uint32_t)valor;
+    });
+}
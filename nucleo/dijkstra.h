@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "colas.h"
+#include "cuadricula.h"
+#include "espacio_busqueda.h"
+#include "estadisticas.h"
+#include "grafo.h"
+#include "grafo_cuadricula.h"
+
+struct ResultadoBusqueda {
+    std::vector<int> camino;          // de inicio a meta; vacio si no hay ruta
+    std::vector<int> nodosVisitados;  // en orden de expansion
+    float costo = INFINITO;
+    int extracciones = 0;             // incluye las entradas obsoletas
+    EstadisticasBusqueda estadisticas;
+};
+
+// Reconstruye el camino siguiendo desde[] hacia atras a partir de la meta.
+inline void reconstruirCamino(const std::vector<int>& desde, int meta, std::vector<int>& camino) {
+    camino.clear();
+    for (int actual = meta; actual != -1; actual = desde[actual]) {
+        camino.push_back(actual);
+    }
+    std::reverse(camino.begin(), camino.end());
+}
+
+inline void reconstruirCamino(const EspacioBusqueda& espacio, int meta, std::vector<int>& camino) {
+    camino.clear();
+    for (int actual = meta; actual != -1; actual = espacio.padre(actual)) {
+        camino.push_back(actual);
+    }
+    std::reverse(camino.begin(), camino.end());
+}
+
+// Heuristica nula: convierte la busqueda en Dijkstra.
+struct SinHeuristica {
+    float operator()(int, int) const { return 0; }
+};
+
+// Busqueda mejor-primero ordenada por g + h(nodo, meta). G debe ofrecer
+// totalNodos() y paraCadaVecino(nodo, f(vecino, costo)), como VistaGrafo
+// (CSR) o GrafoCuadricula (implicito); Cola es cualquiera de colas.h.
+template <class G, class H, class Cola>
+ResultadoBusqueda busquedaMejorPrimero(const G& grafo, EspacioBusqueda& espacio, Cola& cola,
+                                       int inicio, int meta, const H& heuristica) {
+    ResultadoBusqueda resultado;
+    EstadisticasBusqueda& estadisticas = resultado.estadisticas;
+    espacio.preparar(grafo.totalNodos());
+    cola.reservar(grafo.totalNodos());
+    cola.limpiar();
+
+    espacio.fijar(inicio, 0, -1);
+    cola.insertar(inicio, heuristica(inicio, meta));
+    estadisticas.insertar(cola.tamano());
+
+    while (!cola.vacia()) {
+        Estado actual = cola.extraerMin();
+        resultado.extracciones++;
+        if (espacio.cancelada(resultado.extracciones)) return ResultadoBusqueda();
+
+        if (actual.nodo == meta) {
+            break;
+        }
+
+        float distanciaActual = espacio.distancia(actual.nodo);
+        if (actual.costo <= distanciaActual + heuristica(actual.nodo, meta)) {
+            resultado.nodosVisitados.push_back(actual.nodo);
+            estadisticas.expandir();
+
+            auto mejorar = [&](int siguiente, float nuevoCosto) {
+                espacio.fijar(siguiente, nuevoCosto, actual.nodo);
+                cola.insertar(siguiente, nuevoCosto + heuristica(siguiente, meta));
+                estadisticas.insertar(cola.tamano());
+            };
+            // En la cuadricula implicita los 8 vecinos se comparan en bloque
+            if constexpr (std::is_same<G, GrafoCuadricula>::value) {
+                estadisticas.relajar(grafo.paraCadaMejora(espacio, actual.nodo, distanciaActual, mejorar));
+            } else {
+                grafo.paraCadaVecino(actual.nodo, [&](int siguiente, float costo) {
+                    estadisticas.relajar();
+                    float nuevoCosto = distanciaActual + costo;
+                    if (nuevoCosto < espacio.distancia(siguiente)) mejorar(siguiente, nuevoCosto);
+                });
+            }
+        } else {
+            estadisticas.descartar();
+        }
+    }
+
+    if (!espacio.alcanzado(meta)) return resultado;
+    reconstruirCamino(espacio, meta, resultado.camino);
+    resultado.costo = espacio.distancia(meta);
+    return resultado;
+}
+
+template <class G, class H>
+ResultadoBusqueda busquedaMejorPrimero(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                                       const H& heuristica) {
+    return busquedaMejorPrimero(grafo, espacio, espacio.colaBinaria, inicio, meta, heuristica);
+}
+
+template <class G>
+ResultadoBusqueda dijkstra(const G& grafo, EspacioBusqueda& espacio, int inicio, int meta) {
+    return busquedaMejorPrimero(grafo, espacio, inicio, meta, SinHeuristica());
+}
+
+// Sin espacio propio: reserva memoria para una sola consulta.
+template <class G>
+ResultadoBusqueda dijkstra(const G& grafo, int inicio, int meta) {
+    EspacioBusqueda espacio;
+    return dijkstra(grafo, espacio, inicio, meta);
+}
+
+inline ResultadoBusqueda dijkstra(const Grafo& grafo, const Cuadricula& cuadricula, int inicio, int meta) {
+    return dijkstra(VistaGrafo{grafo, cuadricula}, inicio, meta);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "dijkstra.h"
+#include "espacio_busqueda.h"
+
+// Consultas de un origen a varias metas con una sola expansion de Dijkstra,
+// que se detiene en cuanto todas las metas quedan asentadas.
+
+// Metas ordenadas por nodo para localizar rapido las que se asientan.
+inline std::vector<std::pair<int, int>> indexarMetas(const std::vector<int>& metas) {
+    std::vector<std::pair<int, int>> indice;
+    indice.reserve(metas.size());
+    for (int i = 0; i < (int)metas.size(); i++) indice.push_back({metas[i], i});
+    std::sort(indice.begin(), indice.end());
+    return indice;
+}
+
+// Expande desde origen y llama alAsentar(indiceMeta) por cada meta asentada;
+// si devuelve false la busqueda se corta ahi.
+template <class G, class F>
+void expandirHastaMetas(const G& grafo, EspacioBusqueda& espacio, int origen,
+                        const std::vector<std::pair<int, int>>& indice, F&& alAsentar) {
+    ColaBinaria& cola = espacio.colaBinaria;
+    espacio.preparar(grafo.totalNodos());
+    cola.limpiar();
+
+    size_t pendientes = indice.size();
+    espacio.fijar(origen, 0, -1);
+    cola.insertar(origen, 0);
+
+    while (!cola.vacia() && pendientes > 0) {
+        Estado actual = cola.extraerMin();
+        float distanciaActual = espacio.distancia(actual.nodo);
+        if (actual.costo > distanciaActual) continue;
+
+        auto rango = std::equal_range(indice.begin(), indice.end(), std::make_pair(actual.nodo, -1),
+                                      [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+                                          return a.first < b.first;
+                                      });
+        for (auto it = rango.first; it != rango.second; ++it) {
+            pendientes--;
+            if (!alAsentar(it->second)) return;
+        }
+
+        grafo.paraCadaVecino(actual.nodo, [&](int siguiente, float costo) {
+            float nuevoCosto = distanciaActual + costo;
+            if (nuevoCosto < espacio.distancia(siguiente)) {
+                espacio.fijar(siguiente, nuevoCosto, actual.nodo);
+                cola.insertar(siguiente, nuevoCosto);
+            }
+        });
+    }
+}
+
+// Distancia de origen a cada meta (INFINITO si es inalcanzable).
+template <class G>
+std::vector<float> distanciasUnoAMuchos(const G& grafo, EspacioBusqueda& espacio, int origen,
+                                        const std::vector<int>& metas) {
+    std::vector<float> distancias(metas.size(), INFINITO);
+    expandirHastaMetas(grafo, espacio, origen, indexarMetas(metas), [&](int i) {
+        distancias[i] = espacio.distancia(metas[i]);
+        return true;
+    });
+    return distancias;
+}
+
+// Indice de la meta mas cercana a origen (-1 si ninguna es alcanzable) y su
+// ruta en resultado.
+template <class G>
+int metaMasCercana(const G& grafo, EspacioBusqueda& espacio, int origen, const std::vector<int>& metas,
+                   ResultadoBusqueda& resultado) {
+    int elegida = -1;
+    expandirHastaMetas(grafo, espacio, origen, indexarMetas(metas), [&](int i) {
+        elegida = i;
+        return false;
+    });
+    resultado = ResultadoBusqueda();
+    if (elegida == -1) return -1;
+    reconstruirCamino(espacio, metas[elegida], resultado.camino);
+    resultado.costo = espacio.distancia(metas[elegida]);
+    return elegida;
+}
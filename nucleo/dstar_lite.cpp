@@ -0,0 +1,179 @@
+#include "dstar_lite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+PlanificadorIncremental::PlanificadorIncremental(const GrafoCuadricula& grafo)
+    : grafo(grafo), heuristica(crearHeuristica(grafo, TipoHeuristica::Octil)) {}
+
+// Todas las celdas vecinas dentro del mapa, sean o no obstaculo, con el
+// costo del movimiento (simetrico).
+template <class F>
+void PlanificadorIncremental::paraCadaAdyacente(int nodo, F&& f) const {
+    int columnas = grafo.obtenerColumnas();
+    int x = nodo % columnas;
+    int y = nodo / columnas;
+    for (int k = 0; k < 8; k++) {
+        int nx = x + GrafoCuadricula::DX[k];
+        int ny = y + GrafoCuadricula::DY[k];
+        if (grafo.esValido(nx, ny)) f(obtenerIndice(nx, ny, columnas), grafo.costoDireccion(k));
+    }
+}
+
+PlanificadorIncremental::Clave PlanificadorIncremental::calcularClave(int nodo) const {
+    float minimo = min(g[nodo], rhs[nodo]);
+    return {minimo + heuristica(inicio, nodo) + km, minimo};
+}
+
+void PlanificadorIncremental::actualizarVertice(int nodo) {
+    if (g[nodo] != rhs[nodo]) {
+        cola.actualizar(nodo, calcularClave(nodo));
+        contadores.insertar(cola.tamano());
+    } else {
+        cola.quitar(nodo);
+    }
+}
+
+float PlanificadorIncremental::rhsDesdeSucesores(int nodo) const {
+    float mejor = INFINITO;
+    // Entrar en un obstaculo cuesta infinito; salir de uno no
+    grafo.paraCadaVecino(nodo, [&](int sucesor, float costo) {
+        contadores.relajar();
+        mejor = min(mejor, costo + g[sucesor]);
+    });
+    return mejor;
+}
+
+void PlanificadorIncremental::iniciar(int nuevoInicio, int nuevaMeta) {
+    int totalNodos = grafo.totalNodos();
+    contadores = EstadisticasBusqueda();
+    if (ESTADISTICAS_ACTIVAS && (int)g.capacity() < totalNodos) {
+        contadores.bytes = 2 * (long long)(totalNodos - g.capacity()) * sizeof(float);
+    }
+    g.assign(totalNodos, INFINITO);
+    rhs.assign(totalNodos, INFINITO);
+    cola.reservar(totalNodos);
+    cola.limpiar();
+    inicio = ultimoInicio = nuevoInicio;
+    meta = nuevaMeta;
+    km = 0;
+    rhs[meta] = 0;
+    cola.insertar(meta, calcularClave(meta));
+    contadores.insertar(cola.tamano());
+}
+
+void PlanificadorIncremental::moverInicio(int nuevoInicio) {
+    if (!activo() || nuevoInicio == inicio) return;
+    inicio = nuevoInicio;
+    km += heuristica(ultimoInicio, inicio);
+    ultimoInicio = inicio;
+}
+
+void PlanificadorIncremental::notificarCambio(int celda) {
+    if (!activo()) return;
+    // Solo cambian las aristas que entran en la celda
+    bool ahoraObstaculo = grafo.esObstaculo(celda);
+    paraCadaAdyacente(celda, [&](int vecino, float costo) {
+        float costoViejo = ahoraObstaculo ? costo : INFINITO;
+        float costoNuevo = ahoraObstaculo ? INFINITO : costo;
+        if (vecino != meta) {
+            if (costoViejo > costoNuevo) {
+                rhs[vecino] = min(rhs[vecino], costoNuevo + g[celda]);
+            } else if (rhs[vecino] == costoViejo + g[celda]) {
+                rhs[vecino] = rhsDesdeSucesores(vecino);
+            }
+        }
+        actualizarVertice(vecino);
+    });
+}
+
+// La clave del inicio lleva un margen relativo: un nodo de la ruta optima
+// puede quedar con una clave apenas mayor por redondeo y sin procesar, y
+// entonces la ruta que se extrae de g no es consistente.
+PlanificadorIncremental::Clave PlanificadorIncremental::claveLimite() const {
+    Clave clave = calcularClave(inicio);
+    clave.primera += 1e-4f * max(1.0f, clave.primera);
+    return clave;
+}
+
+void PlanificadorIncremental::calcularRutaMasCorta(ResultadoBusqueda& resultado) {
+    while (!cola.vacia() && (cola.prioridadSuperior() < claveLimite() || rhs[inicio] != g[inicio])) {
+        int u = cola.superior();
+        Clave vieja = cola.prioridadSuperior();
+        Clave nueva = calcularClave(u);
+        resultado.extracciones++;
+
+        if (vieja < nueva) {
+            // Clave desactualizada por km: se vuelve a encolar sin procesar
+            cola.actualizar(u, nueva);
+            contadores.descartar();
+            contadores.insertar(cola.tamano());
+        } else if (g[u] > rhs[u]) {
+            g[u] = rhs[u];
+            cola.quitar(u);
+            resultado.nodosVisitados.push_back(u);
+            contadores.expandir();
+            if (grafo.esObstaculo(u)) continue;  // nadie puede entrar en u
+            paraCadaAdyacente(u, [&](int predecesor, float costo) {
+                contadores.relajar();
+                if (predecesor != meta) rhs[predecesor] = min(rhs[predecesor], costo + g[u]);
+                actualizarVertice(predecesor);
+            });
+        } else {
+            float gViejo = g[u];
+            g[u] = INFINITO;
+            resultado.nodosVisitados.push_back(u);
+            contadores.expandir();
+            if (u != meta && rhs[u] == gViejo) rhs[u] = rhsDesdeSucesores(u);
+            actualizarVertice(u);
+            if (grafo.esObstaculo(u)) continue;
+            paraCadaAdyacente(u, [&](int predecesor, float costo) {
+                contadores.relajar();
+                if (predecesor != meta && rhs[predecesor] == costo + gViejo) {
+                    rhs[predecesor] = rhsDesdeSucesores(predecesor);
+                }
+                actualizarVertice(predecesor);
+            });
+        }
+    }
+}
+
+ResultadoBusqueda PlanificadorIncremental::planificar() {
+    ResultadoBusqueda resultado;
+    if (!activo()) return resultado;
+    auto comienzo = chrono::steady_clock::now();
+    calcularRutaMasCorta(resultado);
+    resultado.estadisticas = contadores;
+    contadores = EstadisticasBusqueda();
+    if (ESTADISTICAS_ACTIVAS) {
+        resultado.estadisticas.microsegundos =
+            chrono::duration<double, micro>(chrono::steady_clock::now() - comienzo).count();
+    }
+    if (rhs[inicio] == INFINITO) return resultado;
+
+    // Se desciende por el sucesor que minimiza costo + g hasta la meta
+    resultado.camino.push_back(inicio);
+    resultado.costo = rhs[inicio];
+    int actual = inicio;
+    while (actual != meta && (int)resultado.camino.size() <= grafo.totalNodos()) {
+        int mejor = -1;
+        float mejorCosto = INFINITO;
+        grafo.paraCadaVecino(actual, [&](int sucesor, float costo) {
+            if (costo + g[sucesor] < mejorCosto) {
+                mejorCosto = costo + g[sucesor];
+                mejor = sucesor;
+            }
+        });
+        if (mejor == -1) break;
+        resultado.camino.push_back(mejor);
+        actual = mejor;
+    }
+    if (actual != meta) {
+        resultado.camino.clear();
+        resultado.costo = INFINITO;
+    }
+    return resultado;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "colas.h"
+#include "dijkstra.h"
+#include "grafo_cuadricula.h"
+#include "estadisticas.h"
+#include "heuristica.h"
+
+// Replanificacion incremental D* Lite (Koenig y Likhachev) sobre la
+// cuadricula implicita. Busca desde la meta hacia el agente y conserva g/rhs
+// entre consultas: cuando cambia un obstaculo solo se reparan los nodos cuyo
+// costo a la meta cambia, y el agente puede avanzar sin replanificar.
+//
+// Uso: iniciar(inicio, meta) y planificar(); al mover el agente,
+// moverInicio(); tras alternar un obstaculo en el grafo, notificarCambio().
+class PlanificadorIncremental {
+public:
+    explicit PlanificadorIncremental(const GrafoCuadricula& grafo);
+
+    void iniciar(int inicio, int meta);
+    void moverInicio(int nuevoInicio);
+    // Llamar despues de cambiar el obstaculo de la celda en el grafo.
+    void notificarCambio(int celda);
+
+    // Repara lo necesario y devuelve la ruta desde el inicio actual;
+    // nodosVisitados contiene solo los nodos procesados en esta reparacion, y
+    // las estadisticas incluyen lo que encolaron los cambios notificados.
+    ResultadoBusqueda planificar();
+
+    bool activo() const { return meta != -1; }
+    int obtenerMeta() const { return meta; }
+
+private:
+    struct Clave {
+        float primera;
+        float segunda;
+        bool operator<(const Clave& otra) const {
+            return primera < otra.primera || (primera == otra.primera && segunda < otra.segunda);
+        }
+    };
+
+    Clave calcularClave(int nodo) const;
+    Clave claveLimite() const;
+    void actualizarVertice(int nodo);
+    float rhsDesdeSucesores(int nodo) const;
+    void calcularRutaMasCorta(ResultadoBusqueda& resultado);
+
+    template <class F>
+    void paraCadaAdyacente(int nodo, F&& f) const;
+
+    const GrafoCuadricula& grafo;
+    Heuristica heuristica;
+    std::vector<float> g;
+    std::vector<float> rhs;
+    MonticuloCuaternario<Clave> cola;
+    int inicio = -1;
+    int meta = -1;
+    int ultimoInicio = -1;
+    float km = 0;
+    // Se acumulan hasta el siguiente planificar(); rhsDesdeSucesores cuenta
+    // aristas aunque sea const
+    mutable EstadisticasBusqueda contadores;
+};
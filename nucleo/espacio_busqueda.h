@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "colas.h"
+
+const float INFINITO = std::numeric_limits<float>::infinity();
+
+// Memoria de trabajo reutilizable entre consultas. En lugar de reiniciar
+// distancias y padres en cada busqueda, cada entrada guarda la generacion
+// en la que se escribio; las de generaciones anteriores valen INFINITO/-1.
+// Asi una consulta corta cuesta lo que explora, no lo que mide el mapa.
+// No es seguro compartirla entre hilos: se usa una por hilo.
+class EspacioBusqueda {
+public:
+    struct Entrada {
+        float distancia;
+        int desde;
+        uint32_t generacion;
+    };
+
+    // Empieza una consulta nueva sobre un grafo de totalNodos nodos. Las
+    // colas no se tocan: cada buscador reserva solo la que usa.
+    void preparar(int totalNodos) {
+        if ((int)entradas.size() < totalNodos) entradas.resize(totalNodos);
+        if (++generacion == 0) {
+            // Desborde del contador: unica vez que hay que limpiar todo
+            for (auto& entrada : entradas) entrada.generacion = 0;
+            generacion = 1;
+        }
+    }
+
+    bool alcanzado(int nodo) const { return entradas[nodo].generacion == generacion; }
+    float distancia(int nodo) const { return alcanzado(nodo) ? entradas[nodo].distancia : INFINITO; }
+    int padre(int nodo) const { return alcanzado(nodo) ? entradas[nodo].desde : -1; }
+
+    void fijar(int nodo, float distancia, int padre) {
+        Entrada& entrada = entradas[nodo];
+        entrada.distancia = distancia;
+        entrada.desde = padre;
+        entrada.generacion = generacion;
+    }
+
+    // Segundo espacio para las busquedas bidireccionales; se crea al pedirlo.
+    EspacioBusqueda& complementario() {
+        if (!otro) otro.reset(new EspacioBusqueda());
+        return *otro;
+    }
+
+    // Cancelacion cooperativa: las busquedas largas miran la bandera cada
+    // 1024 extracciones y, si esta puesta, terminan sin camino.
+    void ponerCancelacion(const std::atomic<bool>* bandera) { cancelacion = bandera; }
+    bool cancelada(int extracciones) const {
+        return (extracciones & 1023) == 0 && cancelacion && cancelacion->load(std::memory_order_relaxed);
+    }
+
+    // Acceso directo para los nucleos vectoriales de relajacion.h: una entrada
+    // vale solo si su generacion es la actual.
+    const Entrada* entradasCrudas() const { return entradas.data(); }
+    uint32_t generacionActual() const { return generacion; }
+
+    size_t bytes() const {
+        return entradas.capacity() * sizeof(Entrada) + colaBinaria.bytes() + colaCuaternaria.bytes() +
+               colaRadix.bytes() + (otro ? otro->bytes() : 0);
+    }
+
+    ColaBinaria colaBinaria;
+    MonticuloCuaternario<> colaCuaternaria;
+    MonticuloRadix colaRadix;
+
+private:
+    std::vector<Entrada> entradas;
+    uint32_t generacion = 0;
+    std::unique_ptr<EspacioBusqueda> otro;
+    const std::atomic<bool>* cancelacion = nullptr;
+};
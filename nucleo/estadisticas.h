@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// Contadores por consulta de los buscadores. Se desactivan al compilar con
+// SIN_ESTADISTICAS (opcion ESTADISTICAS_BUSQUEDA de cmake): los metodos
+// quedan vacios y el compilador los quita del bucle.
+#ifdef SIN_ESTADISTICAS
+const bool ESTADISTICAS_ACTIVAS = false;
+#else
+const bool ESTADISTICAS_ACTIVAS = true;
+#endif
+
+struct EstadisticasBusqueda {
+    long long expandidos = 0;   // nodos asentados
+    long long aristas = 0;      // aristas relajadas (examinadas desde un nodo expandido)
+    long long inserciones = 0;  // en la cola, contando las bajadas de prioridad
+    long long obsoletas = 0;    // extracciones descartadas por estar ya mejoradas
+    long long colaMaxima = 0;
+    double microsegundos = 0;   // lo miden buscarRuta, la busqueda por pasos y D* Lite
+    long long bytes = 0;        // lo que crecio el espacio de busqueda mas los vectores del resultado
+
+    void expandir() {
+        if (ESTADISTICAS_ACTIVAS) expandidos++;
+    }
+    void relajar(int cantidad = 1) {
+        if (ESTADISTICAS_ACTIVAS) aristas += cantidad;
+    }
+    void insertar(size_t tamanoCola) {
+        if (!ESTADISTICAS_ACTIVAS) return;
+        inserciones++;
+        colaMaxima = std::max(colaMaxima, (long long)tamanoCola);
+    }
+    void descartar() {
+        if (ESTADISTICAS_ACTIVAS) obsoletas++;
+    }
+
+    // Suma una busqueda auxiliar hecha para esta consulta (los tramos de HPA*).
+    void acumular(const EstadisticasBusqueda& otra) {
+        expandidos += otra.expandidos;
+        aristas += otra.aristas;
+        inserciones += otra.inserciones;
+        obsoletas += otra.obsoletas;
+        colaMaxima = std::max(colaMaxima, otra.colaMaxima);
+    }
+};
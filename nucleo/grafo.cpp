@@ -0,0 +1,55 @@
+#include "grafo.h"
+
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+ConstructorGrafo::ConstructorGrafo(int totalNodos, int aristasEstimadas) {
+    grafo.inicios.assign(totalNodos + 1, 0);
+    grafo.destinos.reserve(aristasEstimadas);
+    grafo.costos.reserve(aristasEstimadas);
+}
+
+void ConstructorGrafo::agregarArista(int desde, int hacia, float costo) {
+    assert(desde >= ultimoOrigen && desde < grafo.totalNodos());
+    while (ultimoOrigen < desde) {
+        grafo.inicios[++ultimoOrigen] = (int)grafo.destinos.size();
+    }
+    grafo.destinos.push_back(hacia);
+    grafo.costos.push_back(costo);
+}
+
+Grafo ConstructorGrafo::construir() {
+    int totalNodos = grafo.totalNodos();
+    while (ultimoOrigen < totalNodos) {
+        grafo.inicios[++ultimoOrigen] = (int)grafo.destinos.size();
+    }
+    return move(grafo);
+}
+
+Grafo construirGrafo(const Cuadricula& cuadricula) {
+    int columnas = cuadricula.columnas;
+    int filas = cuadricula.filas;
+    ConstructorGrafo constructor(cuadricula.totalNodos(), cuadricula.totalNodos() * 8);
+
+    for (int y = 0; y < filas; y++) {
+        for (int x = 0; x < columnas; x++) {
+            int desde = obtenerIndice(x, y, columnas);
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if (!(dx == 0 && dy == 0)) {
+                        int nx = x + dx;
+                        int ny = y + dy;
+                        if (cuadricula.esValido(nx, ny)) {
+                            int hacia = obtenerIndice(nx, ny, columnas);
+                            float distancia = sqrt(dx * dx + dy * dy) * cuadricula.espaciado;
+                            constructor.agregarArista(desde, hacia, distancia);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return constructor.construir();
+}
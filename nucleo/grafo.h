@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include "cuadricula.h"
+
+// Grafo en formato CSR: las aristas de u ocupan [inicios[u], inicios[u + 1])
+// en los arreglos paralelos destinos/costos.
+struct Grafo {
+    std::vector<int> inicios;
+    std::vector<int> destinos;
+    std::vector<float> costos;
+
+    int totalNodos() const { return (int)inicios.size() - 1; }
+    int totalAristas() const { return (int)destinos.size(); }
+};
+
+// Grafo CSR junto con los obstaculos de la cuadricula de la que proviene.
+struct VistaGrafo {
+    const Grafo& grafo;
+    const Cuadricula& cuadricula;
+
+    int totalNodos() const { return grafo.totalNodos(); }
+    int obtenerColumnas() const { return cuadricula.columnas; }
+    float obtenerEspaciado() const { return cuadricula.espaciado; }
+    bool esObstaculo(int nodo) const { return cuadricula.esObstaculo(nodo); }
+
+    template <class F>
+    void paraCadaVecino(int nodo, F&& f) const {
+        for (int arista = grafo.inicios[nodo]; arista < grafo.inicios[nodo + 1]; arista++) {
+            int siguiente = grafo.destinos[arista];
+            if (!cuadricula.esObstaculo(siguiente)) f(siguiente, grafo.costos[arista]);
+        }
+    }
+};
+
+// Construye el CSR en una sola pasada; las aristas deben llegar agrupadas
+// por nodo de origen en orden creciente.
+class ConstructorGrafo {
+public:
+    explicit ConstructorGrafo(int totalNodos, int aristasEstimadas = 0);
+
+    void agregarArista(int desde, int hacia, float costo);
+    Grafo construir();
+
+private:
+    Grafo grafo;
+    int ultimoOrigen = 0;
+};
+
+// Conecta cada celda con sus 8 vecinas; los obstaculos se filtran al buscar.
+Grafo construirGrafo(const Cuadricula& cuadricula);
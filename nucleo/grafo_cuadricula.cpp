@@ -0,0 +1,39 @@
+#include "grafo_cuadricula.h"
+
+#include <cmath>
+#include <random>
+#include <utility>
+
+using namespace std;
+
+// Mismo orden que el doble bucle dx/dy de construirGrafo
+const int GrafoCuadricula::DX[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+const int GrafoCuadricula::DY[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+GrafoCuadricula::GrafoCuadricula(int columnas, int filas, float espaciado)
+    : GrafoCuadricula(MapaBits(columnas, filas), espaciado) {}
+
+GrafoCuadricula::GrafoCuadricula(const Cuadricula& cuadricula)
+    : GrafoCuadricula(cuadricula.obstaculos, cuadricula.espaciado) {}
+
+GrafoCuadricula::GrafoCuadricula(MapaBits obstaculos, float espaciado)
+    : columnas(obstaculos.obtenerColumnas()), filas(obstaculos.obtenerFilas()), espaciado(espaciado),
+      obstaculos(move(obstaculos)) {
+    for (int k = 0; k < 8; k++) {
+        desplazamientos[k] = obtenerIndice(DX[k], DY[k], columnas);
+        costos[k] = sqrt(DX[k] * DX[k] + DY[k] * DY[k]) * espaciado;
+    }
+}
+
+GrafoCuadricula generarGrafoCuadriculaAleatorio(int columnas, int filas, float espaciado, float densidad, unsigned semilla) {
+    // Misma secuencia que generarCuadriculaAleatoria, sin pasar por la Cuadricula
+    GrafoCuadricula grafo(columnas, filas, espaciado);
+    mt19937 generador(semilla);
+    bernoulli_distribution obstaculo(densidad);
+    for (int y = 0; y < filas; y++) {
+        for (int x = 0; x < columnas; x++) {
+            if (obstaculo(generador)) grafo.ponerObstaculo(x, y, true);
+        }
+    }
+    return grafo;
+}
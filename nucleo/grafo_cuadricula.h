@@ -0,0 +1,86 @@
+#pragma once
+
+#include "cuadricula.h"
+#include "espacio_busqueda.h"
+#include "mapa_bits.h"
+#include "relajacion.h"
+
+// Grafo implicito de 8 vecinos: las aristas se calculan a partir de
+// obtenerIndice y un mapa de bits de obstaculos, sin lista de aristas.
+class GrafoCuadricula {
+public:
+    GrafoCuadricula(int columnas, int filas, float espaciado);
+    explicit GrafoCuadricula(const Cuadricula& cuadricula);
+    GrafoCuadricula(MapaBits obstaculos, float espaciado);
+
+    int totalNodos() const { return columnas * filas; }
+    int obtenerColumnas() const { return columnas; }
+    int obtenerFilas() const { return filas; }
+    float obtenerEspaciado() const { return espaciado; }
+
+    bool esValido(int x, int y) const {
+        return x >= 0 && y >= 0 && x < columnas && y < filas;
+    }
+
+    bool esObstaculo(int indice) const { return obstaculos.prueba(indice); }
+    bool esObstaculo(int x, int y) const { return obstaculos.prueba(x, y); }
+    void ponerObstaculo(int indice, bool valor) { obstaculos.poner(indice, valor); }
+    void ponerObstaculo(int x, int y, bool valor) { obstaculos.poner(x, y, valor); }
+    void alternarObstaculo(int indice) { obstaculos.alternar(indice); }
+
+    const MapaBits& obtenerObstaculos() const { return obstaculos; }
+    size_t bytes() const { return obstaculos.bytes(); }
+
+    // Costo del movimiento en la direccion k (DX[k], DY[k]).
+    float costoDireccion(int k) const { return costos[k]; }
+
+    // Bit k: el vecino en la direccion k esta dentro del mapa y es transitable.
+    uint32_t vecinosLibres(int x, int y) const {
+        uint32_t arriba = obstaculos.tresBits(x, y - 1);
+        uint32_t medio = obstaculos.tresBits(x, y);
+        uint32_t abajo = obstaculos.tresBits(x, y + 1);
+        uint32_t bloqueados = (arriba & 1) | (medio & 1) << 1 | (abajo & 1) << 2 | (arriba & 2) << 2 |
+                              (abajo & 2) << 3 | (arriba & 4) << 3 | (medio & 4) << 4 | (abajo & 4) << 5;
+        return ~bloqueados & 0xff;
+    }
+
+    // Llama f(vecino, costo) por cada vecino transitable, en el mismo orden
+    // que construirGrafo.
+    template <class F>
+    void paraCadaVecino(int nodo, F&& f) const {
+        int y = obstaculos.filaDe(nodo);
+        for (uint32_t libres = vecinosLibres(nodo - y * columnas, y); libres; libres &= libres - 1) {
+            int k = bitMasBajo(libres);
+            f(nodo + desplazamientos[k], costos[k]);
+        }
+    }
+
+    // Como paraCadaVecino, pero solo con los vecinos cuya distancia en el
+    // espacio mejora pasando por nodo: f(vecino, nuevaDistancia). Las 8
+    // comparaciones se hacen juntas (relajacion.h). Devuelve cuantos vecinos
+    // transitables se compararon.
+    template <class F>
+    int paraCadaMejora(const EspacioBusqueda& espacio, int nodo, float distancia, F&& f) const {
+        int y = obstaculos.filaDe(nodo);
+        uint32_t libres = vecinosLibres(nodo - y * columnas, y);
+        uint32_t mejoras = mejorasVecinos(espacio, nodo, desplazamientos, costos, distancia, libres);
+        for (; mejoras; mejoras &= mejoras - 1) {
+            int k = bitMasBajo(mejoras);
+            f(nodo + desplazamientos[k], distancia + costos[k]);
+        }
+        return contarBits(libres);
+    }
+
+    static const int DX[8];
+    static const int DY[8];
+
+private:
+    int columnas;
+    int filas;
+    float espaciado;
+    MapaBits obstaculos;
+    int desplazamientos[8];
+    float costos[8];
+};
+
+GrafoCuadricula generarGrafoCuadriculaAleatorio(int columnas, int filas, float espaciado, float densidad, unsigned semilla);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+
+enum class TipoHeuristica { Octil, Euclidiana, Manhattan };
+
+// Distancia estimada entre celdas a partir de sus coordenadas. Octil es
+// exacta en una cuadricula libre de 8 vecinos; Manhattan sobreestima los
+// movimientos diagonales y no es admisible. peso > 1 da A* ponderado:
+// rutas hasta peso veces mas caras que la optima a cambio de expandir menos.
+struct Heuristica {
+    TipoHeuristica tipo = TipoHeuristica::Octil;
+    int columnas = 1;
+    float espaciado = 1;
+    float peso = 1;
+
+    float operator()(int nodo, int meta) const {
+        float dx = (float)std::abs(nodo % columnas - meta % columnas);
+        float dy = (float)std::abs(nodo / columnas - meta / columnas);
+        float distancia;
+        switch (tipo) {
+            case TipoHeuristica::Octil:
+                distancia = std::fabs(dx - dy) + SQRT2 * std::fmin(dx, dy);
+                break;
+            case TipoHeuristica::Euclidiana:
+                distancia = std::sqrt(dx * dx + dy * dy);
+                break;
+            default:
+                distancia = dx + dy;
+                break;
+        }
+        return distancia * espaciado * peso;
+    }
+
+    static constexpr float SQRT2 = 1.41421356f;
+};
+
+template <class G>
+Heuristica crearHeuristica(const G& grafo, TipoHeuristica tipo, float peso = 1) {
+    return Heuristica{tipo, grafo.obtenerColumnas(), grafo.obtenerEspaciado(), peso};
+}
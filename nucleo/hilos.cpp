@@ -0,0 +1,93 @@
+#include "hilos.h"
+
+#include <algorithm>
+
+using namespace std;
+
+GrupoHilos::GrupoHilos(int hilos) {
+    if (hilos <= 0) hilos = max(1u, thread::hardware_concurrency());
+    for (int i = 0; i < hilos; i++) colas.emplace_back(new ColaTrabajo());
+    for (int i = 1; i < hilos; i++) trabajadores.emplace_back(&GrupoHilos::bucleTrabajador, this, i);
+}
+
+GrupoHilos::~GrupoHilos() {
+    {
+        lock_guard<std::mutex> candado(mutex);
+        cerrar = true;
+    }
+    hayTrabajo.notify_all();
+    for (auto& trabajador : trabajadores) trabajador.join();
+}
+
+void GrupoHilos::paraCada(int total, const function<void(int, int)>& tarea, int grano) {
+    if (total <= 0) return;
+    int hilos = totalHilos();
+    if (grano <= 0) grano = max(1, total / (hilos * 16));
+
+    pendientes = total;
+    int siguienteCola = 0;
+    for (int desde = 0; desde < total; desde += grano) {
+        ColaTrabajo& cola = *colas[siguienteCola];
+        lock_guard<std::mutex> candado(cola.mutex);
+        cola.rangos.push_back({desde, min(desde + grano, total), &tarea});
+        siguienteCola = (siguienteCola + 1) % hilos;
+    }
+    {
+        lock_guard<std::mutex> candado(mutex);
+        ronda++;
+    }
+    hayTrabajo.notify_all();
+
+    ejecutarDisponibles(0);
+
+    unique_lock<std::mutex> candado(mutex);
+    terminado.wait(candado, [&] { return pendientes.load() == 0; });
+}
+
+void GrupoHilos::bucleTrabajador(int hilo) {
+    uint64_t rondaVista = 0;
+    while (true) {
+        {
+            unique_lock<std::mutex> candado(mutex);
+            hayTrabajo.wait(candado, [&] { return cerrar || ronda != rondaVista; });
+            if (cerrar) return;
+            rondaVista = ronda;
+        }
+        ejecutarDisponibles(hilo);
+    }
+}
+
+void GrupoHilos::ejecutarDisponibles(int hilo) {
+    Rango rango;
+    while (tomar(hilo, rango)) {
+        for (int i = rango.desde; i < rango.hasta; i++) (*rango.tarea)(i, hilo);
+        if (pendientes.fetch_sub(rango.hasta - rango.desde) == rango.hasta - rango.desde) {
+            lock_guard<std::mutex> candado(mutex);
+            terminado.notify_all();
+        }
+    }
+}
+
+bool GrupoHilos::tomar(int hilo, Rango& rango) {
+    {
+        ColaTrabajo& propia = *colas[hilo];
+        lock_guard<std::mutex> candado(propia.mutex);
+        if (!propia.rangos.empty()) {
+            rango = propia.rangos.front();
+            propia.rangos.pop_front();
+            return true;
+        }
+    }
+    // Robo: se recorre el resto de colas empezando por la vecina
+    int hilos = totalHilos();
+    for (int k = 1; k < hilos; k++) {
+        ColaTrabajo& ajena = *colas[(hilo + k) % hilos];
+        lock_guard<std::mutex> candado(ajena.mutex);
+        if (!ajena.rangos.empty()) {
+            rango = ajena.rangos.back();
+            ajena.rangos.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
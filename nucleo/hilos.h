@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Grupo de hilos persistente con robo de trabajo. paraCada reparte los
+// indices en rangos sobre una cola por hilo; cada hilo consume la suya por
+// delante y, al vaciarse, roba rangos por detras de las demas. El hilo que
+// llama tambien trabaja (es el hilo 0).
+class GrupoHilos {
+public:
+    // hilos <= 0 usa std::thread::hardware_concurrency().
+    explicit GrupoHilos(int hilos = 0);
+    ~GrupoHilos();
+
+    GrupoHilos(const GrupoHilos&) = delete;
+    GrupoHilos& operator=(const GrupoHilos&) = delete;
+
+    int totalHilos() const { return (int)colas.size(); }
+
+    // Ejecuta tarea(indice, hilo) para cada indice en [0, total) y espera a
+    // que terminen todas. hilo esta en [0, totalHilos()) y sirve para usar
+    // memoria de trabajo propia de cada hilo. grano <= 0 elige el tamano de
+    // rango automaticamente.
+    void paraCada(int total, const std::function<void(int indice, int hilo)>& tarea, int grano = 0);
+
+private:
+    struct Rango {
+        int desde;
+        int hasta;
+        const std::function<void(int, int)>* tarea;
+    };
+
+    struct ColaTrabajo {
+        std::mutex mutex;
+        std::deque<Rango> rangos;
+    };
+
+    void bucleTrabajador(int hilo);
+    void ejecutarDisponibles(int hilo);
+    bool tomar(int hilo, Rango& rango);
+
+    std::vector<std::unique_ptr<ColaTrabajo>> colas;
+    std::vector<std::thread> trabajadores;
+
+    std::mutex mutex;
+    std::condition_variable hayTrabajo;
+    std::condition_variable terminado;
+    uint64_t ronda = 0;
+    bool cerrar = false;
+    std::atomic<int> pendientes{0};
+};
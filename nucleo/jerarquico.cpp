@@ -0,0 +1,398 @@
+#include "jerarquico.h"
+
+#include <algorithm>
+
+#include "heuristica.h"
+#include "hilos.h"
+
+using namespace std;
+
+namespace {
+
+// Un cluster visto como grafo propio, con indices locales: los espacios de
+// busqueda solo miden tamano x tamano y las rutas no salen del cluster.
+struct VistaCluster {
+    const GrafoCuadricula& grafo;
+    int x0;
+    int y0;
+    int ancho;
+    int alto;
+
+    int totalNodos() const { return ancho * alto; }
+    int obtenerColumnas() const { return ancho; }
+    float obtenerEspaciado() const { return grafo.obtenerEspaciado(); }
+    bool esObstaculo(int nodo) const { return grafo.esObstaculo(x0 + nodo % ancho, y0 + nodo / ancho); }
+
+    int global(int nodo) const {
+        return obtenerIndice(x0 + nodo % ancho, y0 + nodo / ancho, grafo.obtenerColumnas());
+    }
+
+    int local(int celda) const {
+        int columnas = grafo.obtenerColumnas();
+        return obtenerIndice(celda % columnas - x0, celda / columnas - y0, ancho);
+    }
+
+    template <class F>
+    void paraCadaVecino(int nodo, F&& f) const {
+        int x = nodo % ancho;
+        int y = nodo / ancho;
+        bool interior = x > 0 && y > 0 && x < ancho - 1 && y < alto - 1;
+        for (int k = 0; k < 8; k++) {
+            int dx = GrafoCuadricula::DX[k];
+            int dy = GrafoCuadricula::DY[k];
+            if (!interior && (x + dx < 0 || y + dy < 0 || x + dx >= ancho || y + dy >= alto)) continue;
+            if (!grafo.esObstaculo(x0 + x + dx, y0 + y + dy)) f(nodo + dy * ancho + dx, grafo.costoDireccion(k));
+        }
+    }
+};
+
+float costoMovimiento(const GrafoCuadricula& grafo, int dx, int dy) {
+    for (int k = 0; k < 8; k++) {
+        if (GrafoCuadricula::DX[k] == dx && GrafoCuadricula::DY[k] == dy) return grafo.costoDireccion(k);
+    }
+    return INFINITO;
+}
+
+}  // namespace
+
+MapaJerarquico::MapaJerarquico(const GrafoCuadricula& grafo, int tamanoCluster)
+    : grafo(grafo), tamano(max(tamanoCluster, 2)) {
+    clustersX = (grafo.obtenerColumnas() + tamano - 1) / tamano;
+    clustersY = (grafo.obtenerFilas() + tamano - 1) / tamano;
+    reconstruir();
+}
+
+int MapaJerarquico::clusterDe(int celda) const {
+    int columnas = grafo.obtenerColumnas();
+    return (celda / columnas / tamano) * clustersX + (celda % columnas) / tamano;
+}
+
+void MapaJerarquico::limites(int cluster, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (cluster % clustersX) * tamano;
+    y0 = (cluster / clustersX) * tamano;
+    x1 = min(x0 + tamano, grafo.obtenerColumnas()) - 1;
+    y1 = min(y0 + tamano, grafo.obtenerFilas()) - 1;
+}
+
+int MapaJerarquico::indiceEntrada(const Cluster& cluster, int celda) const {
+    auto it = lower_bound(cluster.entradas.begin(), cluster.entradas.end(), celda);
+    if (it == cluster.entradas.end() || *it != celda) return -1;
+    return (int)(it - cluster.entradas.begin());
+}
+
+// Aristas entre el cluster y uno de sus ocho vecinos. En un borde recto cada
+// tramo de celdas que cruzan en linea recta aporta una transicion en el medio,
+// o una en cada extremo si mide 6 o mas. Como se pueden cortar esquinas,
+// tambien se agregan los cruces diagonales que no quedan cubiertos por un
+// tramo recto y el cruce por la esquina con los vecinos diagonales.
+void MapaJerarquico::transiciones(int cluster, int vecino, vector<pair<int, Salida>>& salida) const {
+    int columnas = grafo.obtenerColumnas();
+    int x0, y0, x1, y1;
+    limites(cluster, x0, y0, x1, y1);
+    int dxc = vecino % clustersX - cluster % clustersX;
+    int dyc = vecino / clustersX - cluster / clustersX;
+
+    auto libre = [&](int x, int y) { return !grafo.esObstaculo(x, y); };
+    auto agregar = [&](int x, int y, int vx, int vy) {
+        salida.push_back({obtenerIndice(x, y, columnas),
+                          {obtenerIndice(vx, vy, columnas), costoMovimiento(grafo, vx - x, vy - y)}});
+    };
+
+    if (dxc != 0 && dyc != 0) {
+        int x = dxc > 0 ? x1 : x0;
+        int y = dyc > 0 ? y1 : y0;
+        if (libre(x, y) && libre(x + dxc, y + dyc)) agregar(x, y, x + dxc, y + dyc);
+        return;
+    }
+
+    // t recorre el borde; celda(t) es la del cluster y celda(t) + (dxc, dyc) la del vecino
+    int desde = dxc != 0 ? y0 : x0;
+    int hasta = dxc != 0 ? y1 : x1;
+    auto celda = [&](int t, int& x, int& y) {
+        x = dxc > 0 ? x1 : dxc < 0 ? x0 : t;
+        y = dyc > 0 ? y1 : dyc < 0 ? y0 : t;
+    };
+    auto cruzaRecto = [&](int t) {
+        int x, y;
+        celda(t, x, y);
+        return libre(x, y) && libre(x + dxc, y + dyc);
+    };
+    auto agregarRecto = [&](int t) {
+        int x, y;
+        celda(t, x, y);
+        agregar(x, y, x + dxc, y + dyc);
+    };
+
+    for (int t = desde; t <= hasta; t++) {
+        if (!cruzaRecto(t)) continue;
+        int fin = t;
+        while (fin < hasta && cruzaRecto(fin + 1)) fin++;
+        if (fin - t + 1 >= 6) {
+            agregarRecto(t);
+            agregarRecto(fin);
+        } else {
+            agregarRecto((t + fin) / 2);
+        }
+        t = fin;
+    }
+
+    for (int t = desde; t < hasta; t++) {
+        if (cruzaRecto(t) || cruzaRecto(t + 1)) continue;
+        int xa, ya, xb, yb;
+        celda(t, xa, ya);
+        celda(t + 1, xb, yb);
+        if (libre(xa, ya) && libre(xb + dxc, yb + dyc)) agregar(xa, ya, xb + dxc, yb + dyc);
+        if (libre(xb, yb) && libre(xa + dxc, ya + dyc)) agregar(xb, yb, xa + dxc, ya + dyc);
+    }
+}
+
+void MapaJerarquico::distanciasEnCluster(EspacioBusqueda& espacio, int cluster, int origen,
+                                         const vector<int>& destinos, vector<float>& distancias,
+                                         EstadisticasBusqueda* estadisticas) const {
+    int x0, y0, x1, y1;
+    limites(cluster, x0, y0, x1, y1);
+    VistaCluster vista{grafo, x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+
+    // Dijkstra local que se corta cuando todos los destinos estan asentados
+    vector<char> esDestino(vista.totalNodos(), 0);
+    int pendientes = 0;
+    for (int destino : destinos) {
+        char& marca = esDestino[vista.local(destino)];
+        pendientes += !marca;
+        marca = 1;
+    }
+
+    EstadisticasBusqueda contadores;
+    ColaBinaria& cola = espacio.colaBinaria;
+    espacio.preparar(vista.totalNodos());
+    cola.limpiar();
+    espacio.fijar(vista.local(origen), 0, -1);
+    cola.insertar(vista.local(origen), 0);
+    contadores.insertar(cola.tamano());
+    while (!cola.vacia() && pendientes > 0) {
+        Estado actual = cola.extraerMin();
+        float distanciaActual = espacio.distancia(actual.nodo);
+        if (actual.costo > distanciaActual) {
+            contadores.descartar();
+            continue;
+        }
+        contadores.expandir();
+        pendientes -= esDestino[actual.nodo];
+        vista.paraCadaVecino(actual.nodo, [&](int siguiente, float costo) {
+            contadores.relajar();
+            float nuevoCosto = distanciaActual + costo;
+            if (nuevoCosto < espacio.distancia(siguiente)) {
+                espacio.fijar(siguiente, nuevoCosto, actual.nodo);
+                cola.insertar(siguiente, nuevoCosto);
+                contadores.insertar(cola.tamano());
+            }
+        });
+    }
+    if (estadisticas) estadisticas->acumular(contadores);
+
+    distancias.resize(destinos.size());
+    for (size_t i = 0; i < destinos.size(); i++) distancias[i] = espacio.distancia(vista.local(destinos[i]));
+}
+
+void MapaJerarquico::construirCluster(int indice, EspacioBusqueda& espacio) {
+    int cx = indice % clustersX;
+    int cy = indice / clustersX;
+    vector<pair<int, Salida>> lista;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int vx = cx + dx;
+            int vy = cy + dy;
+            if ((dx == 0 && dy == 0) || vx < 0 || vy < 0 || vx >= clustersX || vy >= clustersY) continue;
+            transiciones(indice, vy * clustersX + vx, lista);
+        }
+    }
+    sort(lista.begin(), lista.end(), [](const pair<int, Salida>& a, const pair<int, Salida>& b) {
+        return a.first < b.first;
+    });
+
+    Cluster& cluster = clusters[indice];
+    cluster.entradas.clear();
+    cluster.salidas.clear();
+    for (auto& transicion : lista) {
+        if (cluster.entradas.empty() || cluster.entradas.back() != transicion.first) {
+            cluster.entradas.push_back(transicion.first);
+            cluster.salidas.emplace_back();
+        }
+        cluster.salidas.back().push_back(transicion.second);
+    }
+
+    // Las entradas son celdas libres y el costo es simetrico: desde cada
+    // entrada basta con medir hasta las siguientes
+    int total = (int)cluster.entradas.size();
+    cluster.costos.assign(total * total, 0.0f);
+    vector<int> siguientes;
+    vector<float> fila;
+    for (int i = 0; i + 1 < total; i++) {
+        siguientes.assign(cluster.entradas.begin() + i + 1, cluster.entradas.end());
+        distanciasEnCluster(espacio, indice, cluster.entradas[i], siguientes, fila);
+        for (int j = i + 1; j < total; j++) {
+            cluster.costos[i * total + j] = cluster.costos[j * total + i] = fila[j - i - 1];
+        }
+    }
+}
+
+void MapaJerarquico::reconstruir() {
+    clusters.assign(clustersX * clustersY, Cluster());
+    // Cada cluster solo escribe el suyo, asi que se construyen en paralelo
+    GrupoHilos hilos;
+    vector<EspacioBusqueda> espacios(hilos.totalHilos());
+    hilos.paraCada((int)clusters.size(), [&](int i, int hilo) { construirCluster(i, espacios[hilo]); });
+}
+
+void MapaJerarquico::actualizarCelda(int celda) {
+    int columnas = grafo.obtenerColumnas();
+    int x = celda % columnas;
+    int y = celda / columnas;
+    int cluster = clusterDe(celda);
+    int x0, y0, x1, y1;
+    limites(cluster, x0, y0, x1, y1);
+
+    // Una celda interior solo cambia los costos de su cluster
+    EspacioBusqueda espacio;
+    bool borde = x == x0 || x == x1 || y == y0 || y == y1;
+    if (!borde) {
+        construirCluster(cluster, espacio);
+        return;
+    }
+    int cx = cluster % clustersX;
+    int cy = cluster / clustersX;
+    for (int vy = max(cy - 1, 0); vy <= min(cy + 1, clustersY - 1); vy++) {
+        for (int vx = max(cx - 1, 0); vx <= min(cx + 1, clustersX - 1); vx++) {
+            construirCluster(vy * clustersX + vx, espacio);
+        }
+    }
+}
+
+int MapaJerarquico::totalEntradas() const {
+    int total = 0;
+    for (auto& cluster : clusters) total += (int)cluster.entradas.size();
+    return total;
+}
+
+size_t MapaJerarquico::bytes() const {
+    size_t total = clusters.capacity() * sizeof(Cluster);
+    for (auto& cluster : clusters) {
+        total += cluster.entradas.capacity() * sizeof(int) + cluster.costos.capacity() * sizeof(float);
+        for (auto& salidas : cluster.salidas) total += sizeof(salidas) + salidas.capacity() * sizeof(Salida);
+    }
+    return total;
+}
+
+ResultadoBusqueda MapaJerarquico::buscar(EspacioBusqueda& espacio, int inicio, int meta) const {
+    ResultadoBusqueda resultado;
+    EstadisticasBusqueda& estadisticas = resultado.estadisticas;
+    if (inicio == meta) {
+        resultado.camino.push_back(inicio);
+        resultado.costo = 0;
+        return resultado;
+    }
+    if (grafo.esObstaculo(meta)) return resultado;
+
+    // Inicio y meta se enlazan con las entradas de su cluster, y entre si
+    // cuando comparten cluster. Con la meta libre, ir de una entrada a la
+    // meta cuesta lo mismo que volver. Si el inicio es un obstaculo no hay
+    // transicion que lo saque del cluster, asi que sus vecinos de otros
+    // clusters se enlazan igual que el inicio.
+    EspacioBusqueda& local = espacio.complementario();
+    int clusterMeta = clusterDe(meta);
+    vector<int> semillas(1, inicio);
+    vector<float> pasoSemilla(1, 0.0f);
+    if (grafo.esObstaculo(inicio)) {
+        grafo.paraCadaVecino(inicio, [&](int vecino, float costo) {
+            if (clusterDe(vecino) == clusterDe(inicio)) return;
+            semillas.push_back(vecino);
+            pasoSemilla.push_back(costo);
+        });
+    }
+    vector<vector<float>> desdeSemilla(semillas.size());
+    for (size_t s = 0; s < semillas.size(); s++) {
+        int cluster = clusterDe(semillas[s]);
+        vector<int> destinos = clusters[cluster].entradas;
+        if (cluster == clusterMeta) destinos.push_back(meta);
+        distanciasEnCluster(local, cluster, semillas[s], destinos, desdeSemilla[s], &estadisticas);
+    }
+    vector<float> hastaMeta;
+    distanciasEnCluster(local, clusterMeta, meta, clusters[clusterMeta].entradas, hastaMeta, &estadisticas);
+
+    Heuristica heuristica = crearHeuristica(grafo, TipoHeuristica::Octil);
+    ColaBinaria& cola = espacio.colaBinaria;
+    espacio.preparar(grafo.totalNodos());
+    cola.limpiar();
+    espacio.fijar(inicio, 0, -1);
+    cola.insertar(inicio, heuristica(inicio, meta));
+    estadisticas.insertar(cola.tamano());
+
+    auto relajar = [&](int desde, int hacia, float costo) {
+        estadisticas.relajar();
+        float nuevoCosto = espacio.distancia(desde) + costo;
+        if (nuevoCosto < espacio.distancia(hacia)) {
+            espacio.fijar(hacia, nuevoCosto, desde);
+            cola.insertar(hacia, nuevoCosto + heuristica(hacia, meta));
+            estadisticas.insertar(cola.tamano());
+        }
+    };
+
+    while (!cola.vacia()) {
+        Estado actual = cola.extraerMin();
+        resultado.extracciones++;
+        if (espacio.cancelada(resultado.extracciones)) return ResultadoBusqueda();
+        if (actual.nodo == meta) break;
+        if (actual.costo > espacio.distancia(actual.nodo) + heuristica(actual.nodo, meta)) {
+            estadisticas.descartar();
+            continue;
+        }
+        resultado.nodosVisitados.push_back(actual.nodo);
+        estadisticas.expandir();
+
+        for (size_t s = 0; s < semillas.size(); s++) {
+            if (actual.nodo == inicio && s > 0) relajar(inicio, semillas[s], pasoSemilla[s]);
+            if (actual.nodo != semillas[s]) continue;
+            int cluster = clusterDe(semillas[s]);
+            const vector<int>& entradas = clusters[cluster].entradas;
+            for (int j = 0; j < (int)entradas.size(); j++) relajar(actual.nodo, entradas[j], desdeSemilla[s][j]);
+            if (cluster == clusterMeta) relajar(actual.nodo, meta, desdeSemilla[s].back());
+        }
+
+        int indice = clusterDe(actual.nodo);
+        const Cluster& cluster = clusters[indice];
+        int i = indiceEntrada(cluster, actual.nodo);
+        if (i == -1) continue;
+        int total = (int)cluster.entradas.size();
+        for (int j = 0; j < total; j++) {
+            if (j != i) relajar(actual.nodo, cluster.entradas[j], cluster.costos[i * total + j]);
+        }
+        for (const Salida& salida : cluster.salidas[i]) relajar(actual.nodo, salida.celda, salida.costo);
+        if (indice == clusterMeta) relajar(actual.nodo, meta, hastaMeta[i]);
+    }
+
+    if (!espacio.alcanzado(meta)) return resultado;
+    vector<int> abstracto;
+    reconstruirCamino(espacio, meta, abstracto);
+
+    // Refinado: las aristas entre clusters son un paso; las internas se
+    // recorren con A* dentro del cluster
+    resultado.camino.push_back(inicio);
+    for (size_t k = 1; k < abstracto.size(); k++) {
+        int desde = abstracto[k - 1];
+        int hacia = abstracto[k];
+        int indice = clusterDe(desde);
+        if (indice != clusterDe(hacia)) {
+            resultado.camino.push_back(hacia);
+            continue;
+        }
+        int x0, y0, x1, y1;
+        limites(indice, x0, y0, x1, y1);
+        VistaCluster vista{grafo, x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+        ResultadoBusqueda tramo = busquedaMejorPrimero(vista, local, vista.local(desde), vista.local(hacia),
+                                                       crearHeuristica(vista, TipoHeuristica::Octil));
+        for (size_t t = 1; t < tramo.camino.size(); t++) resultado.camino.push_back(vista.global(tramo.camino[t]));
+        estadisticas.acumular(tramo.estadisticas);
+    }
+    resultado.costo = espacio.distancia(meta);
+    return resultado;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "dijkstra.h"
+#include "espacio_busqueda.h"
+#include "grafo_cuadricula.h"
+
+// Busqueda jerarquica HPA* sobre la cuadricula implicita. El mapa se divide
+// en clusters de tamano x tamano celdas; en los bordes entre clusters vecinos
+// se eligen celdas de entrada y dentro de cada cluster se precalcula el costo
+// entre cada par de entradas. Una consulta conecta inicio y meta con las
+// entradas de su cluster, busca en ese grafo abstracto y refina cada tramo
+// con una busqueda limitada al cluster. Las rutas son casi optimas, no
+// optimas: el costo puede superar al de dijkstra.
+class MapaJerarquico {
+public:
+    explicit MapaJerarquico(const GrafoCuadricula& grafo, int tamanoCluster = 32);
+
+    void reconstruir();
+    // Llamar despues de cambiar el obstaculo de la celda en el grafo: se
+    // rehace su cluster y, si la celda esta en el borde, los ocho vecinos.
+    void actualizarCelda(int celda);
+
+    // nodosVisitados contiene los nodos abstractos expandidos. Usa el espacio
+    // y su complementario.
+    ResultadoBusqueda buscar(EspacioBusqueda& espacio, int inicio, int meta) const;
+
+    int obtenerTamanoCluster() const { return tamano; }
+    int totalClusters() const { return (int)clusters.size(); }
+    int totalEntradas() const;
+    size_t bytes() const;
+
+private:
+    struct Salida {
+        int celda;  // entrada del cluster vecino
+        float costo;
+    };
+
+    struct Cluster {
+        std::vector<int> entradas;                 // ordenadas
+        std::vector<float> costos;                 // entradas x entradas, sin salir del cluster
+        std::vector<std::vector<Salida>> salidas;  // aristas a clusters vecinos, por entrada
+    };
+
+    int clusterDe(int celda) const;
+    void limites(int cluster, int& x0, int& y0, int& x1, int& y1) const;
+    void transiciones(int cluster, int vecino, std::vector<std::pair<int, Salida>>& salida) const;
+    void construirCluster(int cluster, EspacioBusqueda& espacio);
+    void distanciasEnCluster(EspacioBusqueda& espacio, int cluster, int origen, const std::vector<int>& destinos,
+                             std::vector<float>& distancias, EstadisticasBusqueda* estadisticas = nullptr) const;
+    int indiceEntrada(const Cluster& cluster, int celda) const;
+
+    const GrafoCuadricula& grafo;
+    int tamano;
+    int clustersX;
+    int clustersY;
+    std::vector<Cluster> clusters;
+};
@@ -0,0 +1,252 @@
+#include "jps.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "heuristica.h"
+
+using namespace std;
+
+namespace {
+
+struct Contexto {
+    const GrafoCuadricula& grafo;
+    const TablaSaltos* tabla;
+    int columnas;
+    int metaX;
+    int metaY;
+
+    bool libre(int x, int y) const {
+        return grafo.esValido(x, y) && !grafo.esObstaculo(x, y);
+    }
+
+    bool bloqueado(int x, int y) const {
+        return grafo.esValido(x, y) && grafo.esObstaculo(x, y);
+    }
+
+    bool forzadoRecto(int x, int y, int dx, int dy) const {
+        if (dy == 0) {
+            return (bloqueado(x, y + 1) && libre(x + dx, y + 1)) || (bloqueado(x, y - 1) && libre(x + dx, y - 1));
+        }
+        return (bloqueado(x + 1, y) && libre(x + 1, y + dy)) || (bloqueado(x - 1, y) && libre(x - 1, y + dy));
+    }
+
+    bool forzadoDiagonal(int x, int y, int dx, int dy) const {
+        return (bloqueado(x - dx, y) && libre(x - dx, y + dy)) || (bloqueado(x, y - dy) && libre(x + dx, y - dy));
+    }
+
+    // Devuelve el indice del siguiente punto de salto o -1.
+    int saltarRecto(int x, int y, int dx, int dy) const {
+        if (tabla) {
+            int direccion = dx > 0 ? 0 : dx < 0 ? 1 : dy > 0 ? 2 : 3;
+            int d = tabla->distancia(direccion, obtenerIndice(x, y, columnas));
+            int alcance = d > 0 ? d : -d;
+            int pasosMeta = dy == 0 ? (metaY == y ? (metaX - x) * dx : -1) : (metaX == x ? (metaY - y) * dy : -1);
+            if (pasosMeta > 0 && pasosMeta <= alcance) return obtenerIndice(metaX, metaY, columnas);
+            return d > 0 ? obtenerIndice(x + dx * d, y + dy * d, columnas) : -1;
+        }
+        while (true) {
+            x += dx;
+            y += dy;
+            if (!libre(x, y)) return -1;
+            if (x == metaX && y == metaY) return obtenerIndice(x, y, columnas);
+            if (forzadoRecto(x, y, dx, dy)) return obtenerIndice(x, y, columnas);
+        }
+    }
+
+    int saltarDiagonal(int x, int y, int dx, int dy) const {
+        while (true) {
+            x += dx;
+            y += dy;
+            if (!libre(x, y)) return -1;
+            if (x == metaX && y == metaY) return obtenerIndice(x, y, columnas);
+            if (forzadoDiagonal(x, y, dx, dy)) return obtenerIndice(x, y, columnas);
+            if (saltarRecto(x, y, dx, 0) != -1 || saltarRecto(x, y, 0, dy) != -1) {
+                return obtenerIndice(x, y, columnas);
+            }
+        }
+    }
+
+    int saltar(int x, int y, int dx, int dy) const {
+        return dx != 0 && dy != 0 ? saltarDiagonal(x, y, dx, dy) : saltarRecto(x, y, dx, dy);
+    }
+};
+
+int signo(int v) {
+    return (v > 0) - (v < 0);
+}
+
+}  // namespace
+
+TablaSaltos::TablaSaltos(const GrafoCuadricula& grafo) {
+    reconstruir(grafo);
+}
+
+void TablaSaltos::reconstruir(const GrafoCuadricula& grafo) {
+    for (auto& s : saltos) s.assign(grafo.totalNodos(), 0);
+    for (int y = 0; y < grafo.obtenerFilas(); y++) calcularFila(grafo, y);
+    for (int x = 0; x < grafo.obtenerColumnas(); x++) calcularColumna(grafo, x);
+}
+
+void TablaSaltos::actualizarCelda(const GrafoCuadricula& grafo, int indice) {
+    int columnas = grafo.obtenerColumnas();
+    int x = indice % columnas;
+    int y = indice / columnas;
+    for (int d = -1; d <= 1; d++) {
+        if (y + d >= 0 && y + d < grafo.obtenerFilas()) calcularFila(grafo, y + d);
+        if (x + d >= 0 && x + d < columnas) calcularColumna(grafo, x + d);
+    }
+}
+
+void TablaSaltos::calcularFila(const GrafoCuadricula& grafo, int y) {
+    Contexto contexto{grafo, nullptr, grafo.obtenerColumnas(), -1, -1};
+    int columnas = grafo.obtenerColumnas();
+    for (int sentido = 0; sentido < 2; sentido++) {
+        int dx = sentido == 0 ? 1 : -1;
+        vector<int>& tabla = saltos[sentido];
+        // Se recorre desde la pared hacia atras para reutilizar el valor del vecino
+        int x = dx > 0 ? columnas - 1 : 0;
+        for (int paso = 0; paso < columnas; paso++, x -= dx) {
+            int siguiente = x + dx;
+            int& valor = tabla[obtenerIndice(x, y, columnas)];
+            if (!contexto.libre(siguiente, y)) valor = 0;
+            else if (contexto.forzadoRecto(siguiente, y, dx, 0)) valor = 1;
+            else {
+                int v = tabla[obtenerIndice(siguiente, y, columnas)];
+                valor = v > 0 ? v + 1 : v - 1;
+            }
+        }
+    }
+}
+
+void TablaSaltos::calcularColumna(const GrafoCuadricula& grafo, int x) {
+    Contexto contexto{grafo, nullptr, grafo.obtenerColumnas(), -1, -1};
+    int columnas = grafo.obtenerColumnas();
+    int filas = grafo.obtenerFilas();
+    for (int sentido = 0; sentido < 2; sentido++) {
+        int dy = sentido == 0 ? 1 : -1;
+        vector<int>& tabla = saltos[2 + sentido];
+        int y = dy > 0 ? filas - 1 : 0;
+        for (int paso = 0; paso < filas; paso++, y -= dy) {
+            int siguiente = y + dy;
+            int& valor = tabla[obtenerIndice(x, y, columnas)];
+            if (!contexto.libre(x, siguiente)) valor = 0;
+            else if (contexto.forzadoRecto(x, siguiente, 0, dy)) valor = 1;
+            else {
+                int v = tabla[obtenerIndice(x, siguiente, columnas)];
+                valor = v > 0 ? v + 1 : v - 1;
+            }
+        }
+    }
+}
+
+ResultadoBusqueda jps(const GrafoCuadricula& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                      const TablaSaltos* tabla) {
+    ResultadoBusqueda resultado;
+    EstadisticasBusqueda& estadisticas = resultado.estadisticas;
+    int columnas = grafo.obtenerColumnas();
+    float costoRecto = grafo.obtenerEspaciado();
+    float costoDiagonal = (float)(sqrt(2.0) * grafo.obtenerEspaciado());
+    Contexto contexto{grafo, tabla, columnas, meta % columnas, meta / columnas};
+    Heuristica heuristica = crearHeuristica(grafo, TipoHeuristica::Octil);
+
+    ColaBinaria& cola = espacio.colaBinaria;
+    espacio.preparar(grafo.totalNodos());
+    cola.limpiar();
+
+    espacio.fijar(inicio, 0, -1);
+    cola.insertar(inicio, heuristica(inicio, meta));
+    estadisticas.insertar(cola.tamano());
+
+    while (!cola.vacia()) {
+        Estado actual = cola.extraerMin();
+        resultado.extracciones++;
+        if (espacio.cancelada(resultado.extracciones)) return ResultadoBusqueda();
+
+        if (actual.nodo == meta) {
+            break;
+        }
+        float distanciaActual = espacio.distancia(actual.nodo);
+        if (actual.costo > distanciaActual + heuristica(actual.nodo, meta)) {
+            estadisticas.descartar();
+            continue;
+        }
+        resultado.nodosVisitados.push_back(actual.nodo);
+        estadisticas.expandir();
+
+        int x = actual.nodo % columnas;
+        int y = actual.nodo / columnas;
+        int direcciones[8][2];
+        int totalDirecciones = 0;
+        auto agregar = [&](int dx, int dy) {
+            direcciones[totalDirecciones][0] = dx;
+            direcciones[totalDirecciones][1] = dy;
+            totalDirecciones++;
+        };
+
+        int padre = espacio.padre(actual.nodo);
+        if (padre == -1) {
+            for (int k = 0; k < 8; k++) agregar(GrafoCuadricula::DX[k], GrafoCuadricula::DY[k]);
+        } else {
+            // Vecinos naturales y forzados segun la direccion de llegada
+            int dx = signo(x - padre % columnas);
+            int dy = signo(y - padre / columnas);
+            if (dx != 0 && dy != 0) {
+                agregar(dx, 0);
+                agregar(0, dy);
+                agregar(dx, dy);
+                if (contexto.bloqueado(x - dx, y)) agregar(-dx, dy);
+                if (contexto.bloqueado(x, y - dy)) agregar(dx, -dy);
+            } else if (dy == 0) {
+                agregar(dx, 0);
+                if (contexto.bloqueado(x, y + 1)) agregar(dx, 1);
+                if (contexto.bloqueado(x, y - 1)) agregar(dx, -1);
+            } else {
+                agregar(0, dy);
+                if (contexto.bloqueado(x + 1, y)) agregar(1, dy);
+                if (contexto.bloqueado(x - 1, y)) agregar(-1, dy);
+            }
+        }
+
+        for (int k = 0; k < totalDirecciones; k++) {
+            int dx = direcciones[k][0];
+            int dy = direcciones[k][1];
+            int salto = contexto.saltar(x, y, dx, dy);
+            if (salto == -1) continue;
+            // Las aristas de JPS son los saltos, no los vecinos recorridos
+            estadisticas.relajar();
+            int pasos = max(abs(salto % columnas - x), abs(salto / columnas - y));
+            float nuevoCosto = distanciaActual + pasos * (dx != 0 && dy != 0 ? costoDiagonal : costoRecto);
+            if (nuevoCosto < espacio.distancia(salto)) {
+                espacio.fijar(salto, nuevoCosto, actual.nodo);
+                cola.insertar(salto, nuevoCosto + heuristica(salto, meta));
+                estadisticas.insertar(cola.tamano());
+            }
+        }
+    }
+
+    if (!espacio.alcanzado(meta)) return resultado;
+
+    // Interpola las celdas entre puntos de salto consecutivos
+    vector<int> puntos;
+    reconstruirCamino(espacio, meta, puntos);
+    resultado.camino.push_back(puntos[0]);
+    for (size_t i = 1; i < puntos.size(); i++) {
+        int x = puntos[i - 1] % columnas;
+        int y = puntos[i - 1] / columnas;
+        int dx = signo(puntos[i] % columnas - x);
+        int dy = signo(puntos[i] / columnas - y);
+        while (obtenerIndice(x, y, columnas) != puntos[i]) {
+            x += dx;
+            y += dy;
+            resultado.camino.push_back(obtenerIndice(x, y, columnas));
+        }
+    }
+    resultado.costo = espacio.distancia(meta);
+    return resultado;
+}
+
+ResultadoBusqueda jps(const GrafoCuadricula& grafo, int inicio, int meta, const TablaSaltos* tabla) {
+    EspacioBusqueda espacio;
+    return jps(grafo, espacio, inicio, meta, tabla);
+}
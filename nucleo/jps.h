@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+#include "dijkstra.h"
+#include "grafo_cuadricula.h"
+
+// Distancias precalculadas de salto recto (JPS+): para cada celda y cada
+// direccion cardinal, d > 0 indica un punto de salto a d celdas y d <= 0
+// indica -d celdas libres antes de una pared. Hay que actualizarla cuando
+// cambian los obstaculos.
+class TablaSaltos {
+public:
+    explicit TablaSaltos(const GrafoCuadricula& grafo);
+
+    void reconstruir(const GrafoCuadricula& grafo);
+    // Recalcula solo las filas y columnas vecinas a la celda modificada.
+    void actualizarCelda(const GrafoCuadricula& grafo, int indice);
+
+    // direccion: 0 = +x, 1 = -x, 2 = +y, 3 = -y
+    int distancia(int direccion, int indice) const { return saltos[direccion][indice]; }
+
+    size_t bytes() const { return saltos[0].size() * sizeof(int) * 4; }
+
+private:
+    void calcularFila(const GrafoCuadricula& grafo, int y);
+    void calcularColumna(const GrafoCuadricula& grafo, int x);
+
+    std::vector<int> saltos[4];
+};
+
+// Jump Point Search sobre la cuadricula de 8 vecinos (se permite cortar
+// esquinas, igual que construirGrafo). nodosVisitados contiene los puntos
+// de salto expandidos; el camino se devuelve celda a celda como en dijkstra.
+// Con tabla se usan los saltos rectos precalculados.
+ResultadoBusqueda jps(const GrafoCuadricula& grafo, EspacioBusqueda& espacio, int inicio, int meta,
+                      const TablaSaltos* tabla = nullptr);
+ResultadoBusqueda jps(const GrafoCuadricula& grafo, int inicio, int meta, const TablaSaltos* tabla = nullptr);
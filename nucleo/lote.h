@@ -0,0 +1,68 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "busqueda.h"
+#include "distancias.h"
+#include "espacio_busqueda.h"
+#include "hilos.h"
+
+// Resuelve muchas consultas (inicio, meta) en paralelo sobre un grafo
+// compartido de solo lectura. Cada hilo usa su propio EspacioBusqueda, que
+// se conserva entre lotes.
+class BuscadorLote {
+public:
+    explicit BuscadorLote(int hilos = 0) : grupo(hilos), espacios(grupo.totalHilos()) {}
+
+    int totalHilos() const { return grupo.totalHilos(); }
+    GrupoHilos& hilos() { return grupo; }
+
+    // Los resultados se devuelven en el mismo orden que las consultas.
+    template <class G>
+    std::vector<ResultadoBusqueda> resolver(const G& grafo, const std::vector<std::pair<int, int>>& consultas,
+                                            const OpcionesBusqueda& opciones) {
+        std::vector<ResultadoBusqueda> resultados(consultas.size());
+        grupo.paraCada((int)consultas.size(), [&](int i, int hilo) {
+            resultados[i] = buscarRuta(grafo, espacios[hilo], consultas[i].first, consultas[i].second, opciones);
+        });
+        return resultados;
+    }
+
+    // Matriz origenes x metas por filas (fila i = origenes[i]); cada fila es
+    // una busqueda uno-a-muchos y las filas se reparten entre los hilos.
+    template <class G>
+    std::vector<float> matrizDistancias(const G& grafo, const std::vector<int>& origenes,
+                                        const std::vector<int>& metas) {
+        std::vector<float> matriz(origenes.size() * metas.size(), INFINITO);
+        std::vector<std::pair<int, int>> indice = indexarMetas(metas);
+        grupo.paraCada((int)origenes.size(), [&](int i, int hilo) {
+            EspacioBusqueda& espacio = espacios[hilo];
+            float* fila = &matriz[i * metas.size()];
+            expandirHastaMetas(grafo, espacio, origenes[i], indice, [&](int j) {
+                fila[j] = espacio.distancia(metas[j]);
+                return true;
+            });
+        }, 1);
+        return matriz;
+    }
+
+    // Para cada origen, indice de su meta mas cercana (-1 si no hay).
+    template <class G>
+    std::vector<int> asignarMetasCercanas(const G& grafo, const std::vector<int>& origenes,
+                                          const std::vector<int>& metas) {
+        std::vector<int> asignadas(origenes.size(), -1);
+        std::vector<std::pair<int, int>> indice = indexarMetas(metas);
+        grupo.paraCada((int)origenes.size(), [&](int i, int hilo) {
+            expandirHastaMetas(grafo, espacios[hilo], origenes[i], indice, [&](int j) {
+                asignadas[i] = j;
+                return false;
+            });
+        });
+        return asignadas;
+    }
+
+private:
+    GrupoHilos grupo;
+    std::vector<EspacioBusqueda> espacios;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Un bit por celda, empaquetado en palabras de 64 bits. Cada fila empieza en
+// una palabra nueva, asi una fila se recorre o se dibuja palabra a palabra.
+class MapaBits {
+public:
+    MapaBits() = default;
+    MapaBits(int columnas, int filas)
+        : columnas(columnas), filas(filas), porFila((columnas + 63) / 64), palabras((size_t)porFila * filas, 0) {
+        calcularInverso();
+    }
+    // Copia palabras ya empaquetadas, por ejemplo de un archivo de mapa.
+    MapaBits(int columnas, int filas, const uint64_t* datos)
+        : columnas(columnas), filas(filas), porFila((columnas + 63) / 64),
+          palabras(datos, datos + (size_t)porFila * filas) {
+        calcularInverso();
+    }
+
+    int obtenerColumnas() const { return columnas; }
+    int obtenerFilas() const { return filas; }
+    int palabrasPorFila() const { return porFila; }
+
+    bool prueba(int x, int y) const { return (palabras[(size_t)y * porFila + (x >> 6)] >> (x & 63)) & 1; }
+    bool prueba(int indice) const {
+        int y = filaDe(indice);
+        return prueba(indice - y * columnas, y);
+    }
+
+    // indice / columnas con una multiplicacion: el inverso se redondea hacia
+    // arriba con 32 + log2(columnas) bits, exacto para indices no negativos.
+    int filaDe(int indice) const { return (int)(((uint64_t)indice * inverso) >> desplazamiento); }
+
+    // Bits de las celdas x - 1, x y x + 1 de la fila y (bit 0 = x - 1); las
+    // que caen fuera del mapa cuentan como puestas.
+    uint32_t tresBits(int x, int y) const {
+        if (y < 0 || y >= filas) return 7;
+        int desde = x - 1;
+        if (desde >= 0 && x + 1 < columnas && (desde & 63) <= 61) {
+            return (uint32_t)(palabras[(size_t)y * porFila + (desde >> 6)] >> (desde & 63)) & 7;
+        }
+        return (desde < 0 || prueba(desde, y)) | prueba(x, y) << 1 | (x + 1 >= columnas || prueba(x + 1, y)) << 2;
+    }
+
+    void poner(int x, int y, bool valor) {
+        uint64_t mascara = uint64_t(1) << (x & 63);
+        uint64_t& palabra = palabras[(size_t)y * porFila + (x >> 6)];
+        if (valor) palabra |= mascara;
+        else palabra &= ~mascara;
+    }
+    void poner(int indice, bool valor) { poner(indice % columnas, indice / columnas, valor); }
+
+    void alternar(int x, int y) { palabras[(size_t)y * porFila + (x >> 6)] ^= uint64_t(1) << (x & 63); }
+    void alternar(int indice) { alternar(indice % columnas, indice / columnas); }
+
+    const uint64_t* fila(int y) const { return palabras.data() + (size_t)y * porFila; }
+    const uint64_t* datos() const { return palabras.data(); }
+    size_t totalPalabras() const { return palabras.size(); }
+    size_t bytes() const { return palabras.size() * sizeof(uint64_t); }
+
+private:
+    void calcularInverso() {
+        int bits = 0;
+        while (bits < 31 && (1 << bits) < columnas) bits++;
+        desplazamiento = 32 + bits;
+        inverso = columnas > 0 ? (uint64_t(1) << desplazamiento) / columnas + 1 : 0;
+    }
+
+    int columnas = 0;
+    int filas = 0;
+    int porFila = 0;
+    std::vector<uint64_t> palabras;
+    uint64_t inverso = 0;
+    int desplazamiento = 32;
+};
@@ -0,0 +1,163 @@
+#include "relajacion.h"
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RELAJACION_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC y Clang necesitan marcar las funciones que usan AVX2; MSVC las compila
+// sin opciones extra.
+#if defined(RELAJACION_X86) && (defined(__GNUC__) || defined(__clang__))
+#define OBJETIVO_AVX2 __attribute__((target("avx2")))
+#else
+#define OBJETIVO_AVX2
+#endif
+
+using namespace std;
+
+namespace {
+
+using Entrada = EspacioBusqueda::Entrada;
+using FuncionMejoras = uint32_t (*)(const Entrada* centro, uint32_t generacion, const int* desplazamientos,
+                                    const float* costos, float distancia, uint32_t libres);
+
+uint32_t mejorasEscalar(const Entrada* centro, uint32_t generacion, const int* desplazamientos, const float* costos,
+                        float distancia, uint32_t libres) {
+    uint32_t mejoras = 0;
+    for (; libres; libres &= libres - 1) {
+        int k = bitMasBajo(libres);
+        const Entrada& entrada = centro[desplazamientos[k]];
+        float actual = entrada.generacion == generacion ? entrada.distancia : INFINITO;
+        if (distancia + costos[k] < actual) mejoras |= 1u << k;
+    }
+    return mejoras;
+}
+
+#ifdef RELAJACION_X86
+
+// Sin gather: se cargan las 8 entradas sin saltos (las direcciones no libres
+// leen la propia celda, que siempre existe) y se compara en dos mitades.
+uint32_t mejorasSSE2(const Entrada* centro, uint32_t generacion, const int* desplazamientos, const float* costos,
+                     float distancia, uint32_t libres) {
+    alignas(16) float distancias[8];
+    alignas(16) uint32_t generaciones[8];
+    for (int k = 0; k < 8; k++) {
+        const Entrada& entrada = centro[(libres >> k) & 1 ? desplazamientos[k] : 0];
+        distancias[k] = entrada.distancia;
+        generaciones[k] = entrada.generacion;
+    }
+    __m128i vigente = _mm_set1_epi32((int)generacion);
+    __m128 infinito = _mm_set1_ps(INFINITO);
+    __m128 base = _mm_set1_ps(distancia);
+    int mascara = 0;
+    for (int mitad = 0; mitad < 2; mitad++) {
+        __m128 valida = _mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)(generaciones + 4 * mitad)), vigente));
+        __m128 actual = _mm_or_ps(_mm_and_ps(valida, _mm_load_ps(distancias + 4 * mitad)),
+                                  _mm_andnot_ps(valida, infinito));
+        __m128 candidato = _mm_add_ps(base, _mm_loadu_ps(costos + 4 * mitad));
+        mascara |= _mm_movemask_ps(_mm_cmplt_ps(candidato, actual)) << (4 * mitad);
+    }
+    return (uint32_t)mascara & libres;
+}
+
+// Gather enmascarado: las direcciones no libres (bordes del mapa) no se leen.
+OBJETIVO_AVX2 uint32_t mejorasAVX2(const Entrada* centro, uint32_t generacion, const int* desplazamientos,
+                                   const float* costos, float distancia, uint32_t libres) {
+    const __m256i bitsCarril = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i activos = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int)libres), bitsCarril), bitsCarril);
+    __m256i bytes = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)desplazamientos),
+                                       _mm256_set1_epi32((int)sizeof(Entrada)));
+    const char* base = reinterpret_cast<const char*>(centro);
+    __m256i generaciones = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(),
+                                                       (const int*)(base + offsetof(Entrada, generacion)), bytes,
+                                                       activos, 1);
+    __m256 infinito = _mm256_set1_ps(INFINITO);
+    __m256 distancias = _mm256_mask_i32gather_ps(infinito, (const float*)(base + offsetof(Entrada, distancia)),
+                                                 bytes, _mm256_castsi256_ps(activos), 1);
+    __m256 valida = _mm256_castsi256_ps(_mm256_cmpeq_epi32(generaciones, _mm256_set1_epi32((int)generacion)));
+    __m256 actual = _mm256_blendv_ps(infinito, distancias, valida);
+    __m256 candidato = _mm256_add_ps(_mm256_set1_ps(distancia), _mm256_loadu_ps(costos));
+    __m256 mejora = _mm256_and_ps(_mm256_cmp_ps(candidato, actual, _CMP_LT_OQ), _mm256_castsi256_ps(activos));
+    return (uint32_t)_mm256_movemask_ps(mejora);
+}
+
+bool cpuTieneAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    // El sistema tiene que guardar los registros ymm (OSXSAVE y XCR0)
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+NivelSimd detectarNivel() {
+#ifdef RELAJACION_X86
+    return cpuTieneAVX2() ? NivelSimd::AVX2 : NivelSimd::SSE2;
+#else
+    return NivelSimd::Escalar;
+#endif
+}
+
+FuncionMejoras funcionDe(NivelSimd nivel) {
+    switch (nivel) {
+#ifdef RELAJACION_X86
+        case NivelSimd::AVX2: return mejorasAVX2;
+        case NivelSimd::SSE2: return mejorasSSE2;
+#endif
+        default: return mejorasEscalar;
+    }
+}
+
+const NivelSimd nivelDisponible = detectarNivel();
+NivelSimd nivelActual = nivelDisponible;
+FuncionMejoras funcionActual = funcionDe(nivelDisponible);
+
+}  // namespace
+
+NivelSimd nivelSimdDisponible() {
+    return nivelDisponible;
+}
+
+NivelSimd nivelSimdActual() {
+    return nivelActual;
+}
+
+NivelSimd elegirNivelSimd(NivelSimd nivel) {
+    nivelActual = (int)nivel <= (int)nivelDisponible ? nivel : nivelDisponible;
+    funcionActual = funcionDe(nivelActual);
+    return nivelActual;
+}
+
+bool leerNivelSimd(const string& nombre, NivelSimd& nivel) {
+    if (nombre == "escalar") nivel = NivelSimd::Escalar;
+    else if (nombre == "sse2") nivel = NivelSimd::SSE2;
+    else if (nombre == "avx2") nivel = NivelSimd::AVX2;
+    else return false;
+    return true;
+}
+
+const char* nombreNivelSimd(NivelSimd nivel) {
+    switch (nivel) {
+        case NivelSimd::SSE2: return "sse2";
+        case NivelSimd::AVX2: return "avx2";
+        default: return "escalar";
+    }
+}
+
+uint32_t mejorasVecinos(const EspacioBusqueda& espacio, int nodo, const int* desplazamientos, const float* costos,
+                        float distancia, uint32_t libres) {
+    return funcionActual(espacio.entradasCrudas() + nodo, espacio.generacionActual(), desplazamientos, costos,
+                         distancia, libres);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "espacio_busqueda.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Relajacion de los 8 vecinos de una celda en bloque: se cargan las 8
+// distancias, se suman los costos de cada direccion y se comparan de una vez.
+// La variante se elige al arrancar segun la CPU (AVX2 con gather, SSE2 o
+// escalar) y se puede forzar para medir.
+enum class NivelSimd { Escalar, SSE2, AVX2 };
+
+NivelSimd nivelSimdDisponible();
+NivelSimd nivelSimdActual();
+// Devuelve el nivel que queda activo: si la CPU no soporta el pedido se usa
+// el disponible. No llamar con busquedas en curso.
+NivelSimd elegirNivelSimd(NivelSimd nivel);
+bool leerNivelSimd(const std::string& nombre, NivelSimd& nivel);
+const char* nombreNivelSimd(NivelSimd nivel);
+
+// Bit k del resultado: el bit k de libres esta puesto y distancia + costos[k]
+// mejora la distancia de nodo + desplazamientos[k] en el espacio.
+uint32_t mejorasVecinos(const EspacioBusqueda& espacio, int nodo, const int* desplazamientos, const float* costos,
+                        float distancia, uint32_t libres);
+
+inline int bitMasBajo(uint32_t mascara) {
+#ifdef _MSC_VER
+    unsigned long indice;
+    _BitScanForward(&indice, mascara);
+    return (int)indice;
+#else
+    return __builtin_ctz(mascara);
+#endif
+}
+
+inline int contarBits(uint32_t mascara) {
+#ifdef _MSC_VER
+    int total = 0;
+    for (; mascara; mascara &= mascara - 1) total++;
+    return total;
+#else
+    return __builtin_popcount(mascara);
+#endif
+}
@@ -0,0 +1,278 @@
+#include "capas_cuadricula.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+
+const Color COLOR_LIBRE(70, 70, 70);
+const Color COLOR_OBSTACULO = Color::Red;
+const Color COLOR_VISITADO(255, 140, 0, 100);
+const Color COLOR_CAMINO = Color::Green;
+
+Uint8 mezclar(Uint8 desde, Uint8 hacia, float t) {
+    return (Uint8)(desde + (hacia - desde) * t + 0.5f);
+}
+
+}  // namespace
+
+CapasCuadricula::CapasCuadricula(const GrafoCuadricula& grafo, float tamanoCelda)
+    : grafo(grafo), tamanoCelda(tamanoCelda), columnas(grafo.obtenerColumnas()), filas(grafo.obtenerFilas()),
+      celdas(Quads), visitados(Quads), camino(LineStrip), agentes(Quads), marcasVisitados(columnas, filas) {
+    reconstruirCeldas();
+}
+
+Vector2f CapasCuadricula::centro(int indice) const {
+    return Vector2f((indice % columnas + 0.5f) * tamanoCelda, (indice / columnas + 0.5f) * tamanoCelda);
+}
+
+// Cuadro de la celda con un pixel de separacion, como los RectangleShape de antes
+void CapasCuadricula::ponerCuadro(Vertex* vertices, int x, int y, Color color) const {
+    float izquierda = x * tamanoCelda + 0.5f;
+    float arriba = y * tamanoCelda + 0.5f;
+    float lado = tamanoCelda - 1;
+    vertices[0] = Vertex(Vector2f(izquierda, arriba), color);
+    vertices[1] = Vertex(Vector2f(izquierda + lado, arriba), color);
+    vertices[2] = Vertex(Vector2f(izquierda + lado, arriba + lado), color);
+    vertices[3] = Vertex(Vector2f(izquierda, arriba + lado), color);
+}
+
+void CapasCuadricula::reconstruirCeldas() {
+    armarNiveles();
+    hayRango = false;
+    nivelTextura = -1;
+}
+
+void CapasCuadricula::actualizarCelda(int indice) {
+    int x = indice % columnas;
+    int y = indice / columnas;
+    bool obstaculo = grafo.esObstaculo(x, y);
+    sumarEnNiveles(obstaculosNivel, x, y, obstaculo ? 1 : -1);
+    if (hayRango && armado.contiene(x, y)) {
+        size_t primero = ((size_t)(y - armado.y0) * (armado.x1 - armado.x0) + (x - armado.x0)) * 4;
+        for (int i = 0; i < 4; i++) celdas[primero + i].color = obstaculo ? COLOR_OBSTACULO : COLOR_LIBRE;
+    }
+}
+
+void CapasCuadricula::ponerVisitados(const vector<int>& nodos) {
+    for (int indice : listaVisitados) marcasVisitados.poner(indice, false);
+    listaVisitados.clear();
+    for (auto& conteos : visitadosNivel) fill(conteos.begin(), conteos.end(), 0);
+    visitados.clear();
+    nivelTextura = -1;
+    for (int indice : nodos) agregarVisitado(indice);
+}
+
+void CapasCuadricula::extenderVisitados(const vector<int>& nodos) {
+    if (nodos.size() < listaVisitados.size()) {
+        ponerVisitados(nodos);
+        return;
+    }
+    for (size_t i = listaVisitados.size(); i < nodos.size(); i++) agregarVisitado(nodos[i]);
+}
+
+void CapasCuadricula::agregarVisitado(int indice) {
+    listaVisitados.push_back(indice);
+    int x = indice % columnas;
+    int y = indice / columnas;
+    if (marcasVisitados.prueba(x, y)) return;
+    marcasVisitados.poner(x, y, true);
+    sumarEnNiveles(visitadosNivel, x, y, 1);
+    if (hayRango && armado.contiene(x, y)) {
+        visitados.resize(visitados.getVertexCount() + 4);
+        ponerCuadro(&visitados[visitados.getVertexCount() - 4], x, y, COLOR_VISITADO);
+    }
+}
+
+void CapasCuadricula::ponerCamino(const vector<int>& nodos) {
+    camino.resize(nodos.size());
+    for (size_t i = 0; i < nodos.size(); i++) camino[i] = Vertex(centro(nodos[i]), COLOR_CAMINO);
+}
+
+// Los agentes se mueven cada cuadro: la capa se rearma entera, pero sigue
+// siendo una sola llamada a draw
+void CapasCuadricula::ponerAgentes(const vector<Vector2f>& posiciones, float radio, Color color) {
+    agentes.resize(posiciones.size() * 4);
+    for (size_t i = 0; i < posiciones.size(); i++) {
+        Vertex* vertices = &agentes[i * 4];
+        Vector2f p = posiciones[i];
+        vertices[0] = Vertex(Vector2f(p.x, p.y - radio), color);
+        vertices[1] = Vertex(Vector2f(p.x + radio, p.y), color);
+        vertices[2] = Vertex(Vector2f(p.x, p.y + radio), color);
+        vertices[3] = Vertex(Vector2f(p.x - radio, p.y), color);
+    }
+}
+
+void CapasCuadricula::armarRango(const Rango& rango) {
+    int ancho = rango.x1 - rango.x0;
+    celdas.resize((size_t)ancho * (rango.y1 - rango.y0) * 4);
+    visitados.clear();
+    size_t i = 0;
+    for (int y = rango.y0; y < rango.y1; y++) {
+        for (int x = rango.x0; x < rango.x1; x++, i += 4) {
+            ponerCuadro(&celdas[i], x, y, grafo.esObstaculo(x, y) ? COLOR_OBSTACULO : COLOR_LIBRE);
+            if (marcasVisitados.prueba(x, y)) {
+                visitados.resize(visitados.getVertexCount() + 4);
+                ponerCuadro(&visitados[visitados.getVertexCount() - 4], x, y, COLOR_VISITADO);
+            }
+        }
+    }
+    armado = rango;
+    hayRango = true;
+}
+
+// Se arma un margen alrededor de lo visible para no rearmar en cada paso
+// de un desplazamiento; al acercarse mucho se rearma para no arrastrar
+// celdas que ya no se ven.
+void CapasCuadricula::dibujarCeldas(RenderTarget& destino, const Rango& visible) {
+    int ancho = visible.x1 - visible.x0;
+    int alto = visible.y1 - visible.y0;
+    if (ancho <= 0 || alto <= 0) return;
+    bool cubre = hayRango && armado.x0 <= visible.x0 && armado.y0 <= visible.y0 && armado.x1 >= visible.x1 &&
+                 armado.y1 >= visible.y1;
+    long areaArmada = (long)(armado.x1 - armado.x0) * (armado.y1 - armado.y0);
+    if (!cubre || areaArmada > 9L * ancho * alto) {
+        int margen = max(8, max(ancho, alto) / 4);
+        Rango rango;
+        rango.x0 = max(0, visible.x0 - margen);
+        rango.y0 = max(0, visible.y0 - margen);
+        rango.x1 = min(columnas, visible.x1 + margen);
+        rango.y1 = min(filas, visible.y1 + margen);
+        armarRango(rango);
+    }
+    destino.draw(celdas);
+    if (visitados.getVertexCount() > 0) destino.draw(visitados);
+}
+
+void CapasCuadricula::armarNiveles() {
+    anchoNivel.assign(1, columnas);
+    altoNivel.assign(1, filas);
+    while (anchoNivel.back() > 1 || altoNivel.back() > 1) {
+        anchoNivel.push_back((anchoNivel.back() + 1) / 2);
+        altoNivel.push_back((altoNivel.back() + 1) / 2);
+    }
+    int niveles = (int)anchoNivel.size();
+    // El nivel 0 son los mapas de bits; sus vectores quedan vacios
+    obstaculosNivel.assign(niveles, vector<uint32_t>());
+    visitadosNivel.assign(niveles, vector<uint32_t>());
+    for (int n = 1; n < niveles; n++) {
+        obstaculosNivel[n].assign((size_t)anchoNivel[n] * altoNivel[n], 0);
+        visitadosNivel[n].assign((size_t)anchoNivel[n] * altoNivel[n], 0);
+    }
+    if (niveles == 1) return;
+    for (int y = 0; y < filas; y++) {
+        for (int x = 0; x < columnas; x++) {
+            size_t bloque = (size_t)(y >> 1) * anchoNivel[1] + (x >> 1);
+            obstaculosNivel[1][bloque] += grafo.esObstaculo(x, y);
+            visitadosNivel[1][bloque] += marcasVisitados.prueba(x, y);
+        }
+    }
+    for (int n = 2; n < niveles; n++) {
+        for (int y = 0; y < altoNivel[n - 1]; y++) {
+            for (int x = 0; x < anchoNivel[n - 1]; x++) {
+                size_t hijo = (size_t)y * anchoNivel[n - 1] + x;
+                size_t bloque = (size_t)(y >> 1) * anchoNivel[n] + (x >> 1);
+                obstaculosNivel[n][bloque] += obstaculosNivel[n - 1][hijo];
+                visitadosNivel[n][bloque] += visitadosNivel[n - 1][hijo];
+            }
+        }
+    }
+}
+
+// Tambien repinta el pixel de la textura en uso, si hay una
+void CapasCuadricula::sumarEnNiveles(vector<vector<uint32_t>>& conteos, int x, int y, int delta) {
+    for (int n = 1; n < (int)conteos.size(); n++) {
+        conteos[n][(size_t)(y >> n) * anchoNivel[n] + (x >> n)] += delta;
+    }
+    if (nivelTextura < 0) return;
+    int bloque = (y >> nivelTextura) * anchoNivel[nivelTextura] + (x >> nivelTextura);
+    Color color = colorBloque(nivelTextura, bloque);
+    Uint8* pixel = &pixeles[(size_t)bloque * 4];
+    pixel[0] = color.r;
+    pixel[1] = color.g;
+    pixel[2] = color.b;
+    pixel[3] = color.a;
+    texturaSucia = true;
+}
+
+// Fraccion de obstaculos entre libre y obstaculo, y encima la de visitados
+// con la misma transparencia que la capa de visitados
+Color CapasCuadricula::colorBloque(int nivel, int bloque) const {
+    float obstaculos, vistos;
+    if (nivel == 0) {
+        obstaculos = grafo.esObstaculo(bloque);
+        vistos = marcasVisitados.prueba(bloque);
+    } else {
+        int bx = bloque % anchoNivel[nivel];
+        int by = bloque / anchoNivel[nivel];
+        int lado = 1 << nivel;
+        // Los bloques del borde pueden tener menos celdas
+        float celdasBloque = (float)(min(lado, columnas - bx * lado) * min(lado, filas - by * lado));
+        obstaculos = obstaculosNivel[nivel][bloque] / celdasBloque;
+        vistos = visitadosNivel[nivel][bloque] / celdasBloque;
+    }
+    float t = vistos * COLOR_VISITADO.a / 255.f;
+    Color base(mezclar(COLOR_LIBRE.r, COLOR_OBSTACULO.r, obstaculos),
+               mezclar(COLOR_LIBRE.g, COLOR_OBSTACULO.g, obstaculos),
+               mezclar(COLOR_LIBRE.b, COLOR_OBSTACULO.b, obstaculos));
+    return Color(mezclar(base.r, COLOR_VISITADO.r, t), mezclar(base.g, COLOR_VISITADO.g, t),
+                 mezclar(base.b, COLOR_VISITADO.b, t));
+}
+
+void CapasCuadricula::dibujarReducido(RenderTarget& destino, int nivel) {
+    int ancho = anchoNivel[nivel];
+    int alto = altoNivel[nivel];
+    if (nivel != nivelTextura) {
+        pixeles.resize((size_t)ancho * alto * 4);
+        for (int bloque = 0; bloque < ancho * alto; bloque++) {
+            Color color = colorBloque(nivel, bloque);
+            Uint8* pixel = &pixeles[(size_t)bloque * 4];
+            pixel[0] = color.r;
+            pixel[1] = color.g;
+            pixel[2] = color.b;
+            pixel[3] = color.a;
+        }
+        textura.create(ancho, alto);
+        textura.setSmooth(false);
+        nivelTextura = nivel;
+        texturaSucia = true;
+    }
+    if (texturaSucia) {
+        textura.update(pixeles.data());
+        texturaSucia = false;
+    }
+    Sprite sprite(textura);
+    float escala = tamanoCelda * (1 << nivel);
+    sprite.setScale(escala, escala);
+    destino.draw(sprite);
+}
+
+void CapasCuadricula::dibujar(RenderTarget& destino) {
+    const View& vista = destino.getView();
+    float pixelesPorCelda = tamanoCelda * destino.getSize().x / vista.getSize().x;
+    if (pixelesPorCelda >= PIXELES_DETALLE) {
+        Vector2f esquina = vista.getCenter() - vista.getSize() / 2.f;
+        Rango visible;
+        visible.x0 = max(0, (int)floor(esquina.x / tamanoCelda));
+        visible.y0 = max(0, (int)floor(esquina.y / tamanoCelda));
+        visible.x1 = min(columnas, (int)ceil((esquina.x + vista.getSize().x) / tamanoCelda));
+        visible.y1 = min(filas, (int)ceil((esquina.y + vista.getSize().y) / tamanoCelda));
+        dibujarCeldas(destino, visible);
+        nivelDibujado = -1;
+    } else {
+        // Nivel en el que un bloque ocupa al menos un pixel y que entra en
+        // una textura
+        int nivel = 0;
+        int ultimo = (int)anchoNivel.size() - 1;
+        while (nivel < ultimo && pixelesPorCelda * (1 << nivel) < 1) nivel++;
+        unsigned maximo = Texture::getMaximumSize();
+        while (nivel < ultimo && (unsigned)max(anchoNivel[nivel], altoNivel[nivel]) > maximo) nivel++;
+        dibujarReducido(destino, nivel);
+        nivelDibujado = nivel;
+    }
+    if (camino.getVertexCount() > 1) destino.draw(camino);
+    if (agentes.getVertexCount() > 0) destino.draw(agentes);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "grafo_cuadricula.h"
+#include "mapa_bits.h"
+
+// Dibujo de la cuadricula por capas (celdas, visitados, camino, agentes)
+// segun la vista del destino. De cerca solo se arman las celdas visibles,
+// en un VertexArray por capa que se conserva mientras la vista no se mueva;
+// de lejos, cuando una celda ocupa menos de PIXELES_DETALLE pixeles, se
+// dibuja una textura reducida (como un mipmap) en la que cada pixel resume
+// un bloque de 2^nivel x 2^nivel celdas. En ambos casos cada capa es una
+// sola llamada a draw.
+class CapasCuadricula {
+public:
+    static constexpr float PIXELES_DETALLE = 4;
+
+    CapasCuadricula(const GrafoCuadricula& grafo, float tamanoCelda);
+
+    // Vuelve a leer todas las celdas, por ejemplo tras cargar otro mapa.
+    void reconstruirCeldas();
+    // La celda cambio entre obstaculo y libre.
+    void actualizarCelda(int indice);
+
+    void ponerVisitados(const std::vector<int>& nodos);
+    // nodos empieza con los ya puestos (busqueda por pasos): solo se agregan
+    // los nuevos; si no, se vuelve a armar la capa.
+    void extenderVisitados(const std::vector<int>& nodos);
+    void ponerCamino(const std::vector<int>& camino);
+    void ponerAgentes(const std::vector<sf::Vector2f>& posiciones, float radio, sf::Color color);
+
+    // Usa la vista actual del destino.
+    void dibujar(sf::RenderTarget& destino);
+
+    // -1 si el ultimo cuadro se dibujo celda a celda
+    int nivelDetalle() const { return nivelDibujado; }
+
+    // Centro de la celda en pixeles
+    sf::Vector2f centro(int indice) const;
+
+private:
+    struct Rango {
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        bool contiene(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+    };
+
+    void ponerCuadro(sf::Vertex* vertices, int x, int y, sf::Color color) const;
+    void armarRango(const Rango& rango);
+    void agregarVisitado(int indice);
+    void dibujarCeldas(sf::RenderTarget& destino, const Rango& rango);
+
+    // Conteos por bloque de cada nivel: nivel 0 son las celdas y el bloque
+    // del nivel n + 1 suma 2x2 bloques del nivel n.
+    void armarNiveles();
+    void sumarEnNiveles(std::vector<std::vector<uint32_t>>& conteos, int x, int y, int delta);
+    void dibujarReducido(sf::RenderTarget& destino, int nivel);
+    sf::Color colorBloque(int nivel, int bloque) const;
+
+    const GrafoCuadricula& grafo;
+    float tamanoCelda;
+    int columnas;
+    int filas;
+
+    // Celdas visibles: vertices del rango armado, fila por fila
+    Rango armado;
+    bool hayRango = false;
+    sf::VertexArray celdas;
+    sf::VertexArray visitados;
+    sf::VertexArray camino;
+    sf::VertexArray agentes;
+
+    MapaBits marcasVisitados;
+    std::vector<int> listaVisitados;
+
+    std::vector<int> anchoNivel;
+    std::vector<int> altoNivel;
+    std::vector<std::vector<uint32_t>> obstaculosNivel;
+    std::vector<std::vector<uint32_t>> visitadosNivel;
+    // Pixeles y textura del nivel que se esta mostrando
+    int nivelTextura = -1;
+    bool texturaSucia = true;
+    std::vector<sf::Uint8> pixeles;
+    sf::Texture textura;
+    int nivelDibujado = -1;
+};
+
+// Cuadros por segundo y tiempo de cuadro, promediados cada medio segundo.
+class ContadorCuadros {
+public:
+    // Devuelve true cuando hay valores nuevos que mostrar.
+    bool registrar() {
+        float segundos = reloj.restart().asSeconds();
+        acumulado += segundos;
+        peor = segundos > peor ? segundos : peor;
+        cuadros++;
+        if (acumulado < 0.5f) return false;
+        porSegundo = cuadros / acumulado;
+        milisegundos = 1000 * acumulado / cuadros;
+        maximo = 1000 * peor;
+        acumulado = peor = 0;
+        cuadros = 0;
+        return true;
+    }
+
+    float cuadrosPorSegundo() const { return porSegundo; }
+    float msPorCuadro() const { return milisegundos; }
+    float msMaximo() const { return maximo; }
+
+private:
+    sf::Clock reloj;
+    float acumulado = 0;
+    float peor = 0;
+    int cuadros = 0;
+    float porSegundo = 0;
+    float milisegundos = 0;
+    float maximo = 0;
+};
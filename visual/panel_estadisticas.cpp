@@ -0,0 +1,77 @@
+#include "panel_estadisticas.h"
+
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+using namespace sf;
+
+namespace {
+
+const unsigned TAMANO_LETRA = 14;
+const float MARGEN = 8;
+
+const char* const FUENTES[] = {
+    "fuente.ttf",
+    "C:/Windows/Fonts/consola.ttf",
+    "C:/Windows/Fonts/arial.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+    "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+    "/Library/Fonts/Arial.ttf",
+};
+
+}  // namespace
+
+PanelEstadisticas::PanelEstadisticas() {
+    for (const char* ruta : FUENTES) {
+        if (fuente.loadFromFile(ruta)) {
+            fuenteCargada = true;
+            break;
+        }
+    }
+    texto.setFont(fuente);
+    texto.setCharacterSize(TAMANO_LETRA);
+    texto.setFillColor(Color::White);
+    texto.setPosition(2 * MARGEN, 2 * MARGEN);
+    fondo.setFillColor(Color(0, 0, 0, 180));
+    fondo.setPosition(MARGEN, MARGEN);
+}
+
+void PanelEstadisticas::mostrar(const string& algoritmo, const ResultadoBusqueda& resultado) {
+    const EstadisticasBusqueda& e = resultado.estadisticas;
+    char lineas[512];
+    int lineasTotales = 0;
+    if (!ESTADISTICAS_ACTIVAS) {
+        snprintf(lineas, sizeof(lineas), "%s\nexpandidos   %zu\n(compilado sin estadisticas)", algoritmo.c_str(),
+                 resultado.nodosVisitados.size());
+        lineasTotales = 3;
+    } else {
+        snprintf(lineas, sizeof(lineas),
+                 "%s\nexpandidos   %lld\naristas      %lld\ninserciones  %lld\nobsoletas    %lld\n"
+                 "cola maxima  %lld\ntiempo       %.2f ms\nmemoria      %.1f KB\ncosto        %.1f",
+                 algoritmo.c_str(), e.expandidos, e.aristas, e.inserciones, e.obsoletas, e.colaMaxima,
+                 e.microsegundos / 1000, e.bytes / 1024.0, resultado.costo);
+        lineasTotales = 9;
+    }
+    contenido = lineas;
+    texto.setString(contenido);
+    fondo.setSize(Vector2f(16 * TAMANO_LETRA + 2 * MARGEN, lineasTotales * (TAMANO_LETRA + 3) + 2 * MARGEN));
+    if (visible && !fuenteCargada) cout << contenido << endl;
+}
+
+bool PanelEstadisticas::alternar() {
+    visible = !visible;
+    if (visible && !fuenteCargada && !contenido.empty()) cout << contenido << endl;
+    return visible;
+}
+
+void PanelEstadisticas::dibujar(RenderTarget& destino) {
+    if (!visible || !fuenteCargada || contenido.empty()) return;
+    // En pixeles de la ventana, sin la camara
+    View anterior = destino.getView();
+    Vector2u tamano = destino.getSize();
+    destino.setView(View(FloatRect(0, 0, (float)tamano.x, (float)tamano.y)));
+    destino.draw(fondo);
+    destino.draw(texto);
+    destino.setView(anterior);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+
+#include "dijkstra.h"
+
+// Recuadro con los contadores de la ultima busqueda, dibujado en
+// coordenadas de pantalla sobre el mapa. Usa la primera fuente del sistema
+// que encuentre; sin fuente, mientras esta visible escribe los contadores
+// por consola.
+class PanelEstadisticas {
+public:
+    PanelEstadisticas();
+
+    bool tieneFuente() const { return fuenteCargada; }
+    // Devuelve si quedo visible.
+    bool alternar();
+
+    void mostrar(const std::string& algoritmo, const ResultadoBusqueda& resultado);
+
+    void dibujar(sf::RenderTarget& destino);
+
+private:
+    sf::Font fuente;
+    bool fuenteCargada = false;
+    bool visible = false;
+    sf::Text texto;
+    sf::RectangleShape fondo;
+    std::string contenido;
+};